@@ -0,0 +1,35 @@
+#ifndef PRECISION_BENCH_UTIL_HXX
+#define PRECISION_BENCH_UTIL_HXX
+
+#include <chrono>
+#include <cstddef>
+
+namespace bench {
+  /// Clock of the measurements.
+  typedef std::chrono::steady_clock clock;
+
+  /**
+   * Runs @p f until at least 200ms have passed.
+   *
+   * @param f Function to measure.
+   * @param items Items processed by one call of @p f.
+   * @return Millions of items per second.
+   */
+  template<class _PCS_FUNCTION>
+  double measure( _PCS_FUNCTION f, double items )
+  {
+    size_t runs = 0;
+    clock::time_point start = clock::now();
+    std::chrono::duration<double> elapsed;
+
+    do {
+      f();
+      runs++;
+      elapsed = clock::now() - start;
+    } while( elapsed.count() < 0.2 );
+
+    return items * runs / elapsed.count() / 1e6;
+  }
+}
+
+#endif // PRECISION_BENCH_UTIL_HXX
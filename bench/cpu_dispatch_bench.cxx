@@ -0,0 +1,90 @@
+
+/*
+ * Throughput of precision::simd_kernels at every instruction set level
+ * supported by the running CPU.
+ *
+ * Usage: cpu_dispatch_bench [number of values]
+ */
+
+#include <bench/bench_util.hxx>
+#include <precision/cpu_dispatch.hxx>
+#include <precision/simd_kernels.hxx>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+  std::vector<double> random_values( size_t n )
+  {
+    std::vector<double> v( n );
+    for( size_t i = 0; i < n; i++ ) {
+      v[i] = std::rand() / ( RAND_MAX + 1.0 ) * 1000.0;
+    }
+    return v;
+  }
+}
+
+int main( int argc, char** argv )
+{
+  using precision::cpu_dispatch;
+  using precision::simd_kernels;
+
+  size_t n = ( argc > 1 ) ? std::strtoul( argv[1], 0, 10 ) : 1 << 16;
+  size_t pairs_n = ( n < 2000 ) ? n : 2000;
+
+  std::vector<double> x1 = random_values( n ), y1 = random_values( n );
+  std::vector<double> x2 = random_values( n ), y2 = random_values( n );
+  std::vector<double> out( n );
+  double sum;
+  size_t invalid;
+
+  std::printf( "best level: %s\n",
+               cpu_dispatch::to_string( cpu_dispatch::get_best_level() ) );
+  std::printf( "%-8s %14s %14s %14s %14s %14s %14s\n", "level",
+               "sq_dist M/s", "dist M/s", "linear M/s", "normal M/s",
+               "length M/s", "aniso M/s" );
+
+  const cpu_dispatch::level levels[] = {
+    cpu_dispatch::GENERIC, cpu_dispatch::AVX2, cpu_dispatch::AVX512
+  };
+
+  for( size_t l = 0; l < sizeof( levels ) / sizeof( levels[0] ); l++ ) {
+    if( !cpu_dispatch::set_level( levels[l] ) ) {
+      continue;
+    }
+
+    double pairs = pairs_n * ( pairs_n - 1 ) / 2.0;
+
+    double sq = bench::measure( [&]() {
+        simd_kernels::squared_distances( &x1[0], &y1[0], &x2[0], &y2[0],
+                                         &out[0], n );
+      }, n );
+    double dist = bench::measure( [&]() {
+        simd_kernels::distances( &x1[0], &y1[0], &x2[0], &y2[0],
+                                 &out[0], n );
+      }, n );
+    double lin = bench::measure( [&]() {
+        simd_kernels::linear( &x1[0], &y1[0], &x2[0], &out[0], n );
+      }, n );
+    double norm = bench::measure( [&]() {
+        simd_kernels::normalize( &x1[0], 500.0, 250.0, &out[0], n );
+      }, n );
+    double length = bench::measure( [&]() {
+        simd_kernels::pairwise_length_ratio( &x1[0], &y1[0], &x2[0], &y2[0],
+                                             pairs_n, sum );
+      }, pairs );
+    double aniso = bench::measure( [&]() {
+        simd_kernels::pairwise_anisomorphism( &x1[0], &y1[0], &x2[0], &y2[0],
+                                              pairs_n, sum, invalid );
+      }, pairs );
+
+    std::printf( "%-8s %14.1f %14.1f %14.1f %14.1f %14.1f %14.1f\n",
+                 cpu_dispatch::to_string( levels[l] ),
+                 sq, dist, lin, norm, length, aniso );
+  }
+
+  cpu_dispatch::reset_level();
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Throughput and accuracy of precision::bicubic and the windowed sinc
+ * kernels of precision::sinc_kernel, interpolating a smooth test image at
+ * random positions and resampling it to twice its size.
+ *
+ * Usage: resampling_bench [image size]
+ */
+
+#include <bench/bench_util.hxx>
+#include <precision/interpolation.hxx>
+#include <precision/sinc_kernel.hxx>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+  /// Band-limited test image, known at any position.
+  double image_at( double x, double y )
+  {
+    return std::sin( 0.35 * x ) + std::cos( 0.27 * y ) * std::sin( 0.11 * x );
+  }
+
+  double bicubic_at( const std::vector<double>& image, size_t width,
+                     double x, double y )
+  {
+    size_t ix = static_cast<size_t>( x ), iy = static_cast<size_t>( y );
+    const double* f = &image[( iy - 1 ) * width + ix - 1];
+    const double* g = f + width;
+    const double* h = g + width;
+    const double* k = h + width;
+
+    return precision::bicubic( ix - 1.0, ix + 2.0, iy - 1.0, iy + 2.0,
+                               f[0], f[1], f[2], f[3], g[0], g[1], g[2], g[3],
+                               h[0], h[1], h[2], h[3], k[0], k[1], k[2], k[3],
+                               x, y );
+  }
+
+  double rms( const std::vector<double>& values,
+              const std::vector<double>& expected )
+  {
+    double sum = 0.0;
+    for( size_t i = 0; i < values.size(); i++ ) {
+      sum += ( values[i] - expected[i] ) * ( values[i] - expected[i] );
+    }
+    return std::sqrt( sum / values.size() );
+  }
+
+  /**
+   * RMS of the pixels of a square image at least @p margin pixels away
+   * from its borders.
+   */
+  double rms_inner( const std::vector<double>& values,
+                    const std::vector<double>& expected, size_t width,
+                    size_t margin )
+  {
+    double sum = 0.0;
+    size_t count = 0;
+
+    for( size_t j = margin; j + margin < width; j++ ) {
+      for( size_t i = margin; i + margin < width; i++ ) {
+        double d = values[j * width + i] - expected[j * width + i];
+        sum += d * d;
+        count++;
+      }
+    }
+    return std::sqrt( sum / count );
+  }
+
+  template<size_t _PCS_RADIUS>
+  void run_sinc( const char* name,
+                 const precision::sinc_kernel<_PCS_RADIUS>& kernel,
+                 const std::vector<double>& image, size_t size,
+                 const std::vector<double>& x, const std::vector<double>& y,
+                 const std::vector<double>& expected,
+                 const std::vector<double>& expected_2x )
+  {
+    std::vector<double> out( x.size() ), out_2x( 4 * size * size );
+
+    double points = bench::measure( [&]() {
+        for( size_t i = 0; i < x.size(); i++ ) {
+          out[i] = kernel.interpolate( &image[0], size, size, x[i], y[i] );
+        }
+      }, x.size() );
+    double resample = bench::measure( [&]() {
+        kernel.resample( &image[0], size, size, &out_2x[0],
+                         2 * size, 2 * size );
+      }, out_2x.size() );
+
+    std::printf( "%-12s %14.2f %14.2e %14.2f %14.2e\n", name, points,
+                 rms( out, expected ), resample,
+                 rms_inner( out_2x, expected_2x, 2 * size, 16 ) );
+  }
+}
+
+int main( int argc, char** argv )
+{
+  size_t size = ( argc > 1 ) ? std::strtoul( argv[1], 0, 10 ) : 512;
+  size_t n = 1 << 16;
+
+  if( size < 16 ) {
+    size = 16;
+  }
+
+  std::vector<double> image( size * size );
+  for( size_t j = 0; j < size; j++ ) {
+    for( size_t i = 0; i < size; i++ ) {
+      image[j * size + i] = image_at( i, j );
+    }
+  }
+
+  // Positions away from the borders, where every method has its samples.
+  std::vector<double> x( n ), y( n ), expected( n );
+  for( size_t i = 0; i < n; i++ ) {
+    x[i] = 4.0 + std::rand() / ( RAND_MAX + 1.0 ) * ( size - 9.0 );
+    y[i] = 4.0 + std::rand() / ( RAND_MAX + 1.0 ) * ( size - 9.0 );
+    expected[i] = image_at( x[i], y[i] );
+  }
+
+  // Twice the size, with pixel centers aligned; only the inner part is
+  // compared.
+  std::vector<double> expected_2x( 4 * size * size );
+  for( size_t j = 0; j < 2 * size; j++ ) {
+    for( size_t i = 0; i < 2 * size; i++ ) {
+      expected_2x[j * 2 * size + i] = image_at( ( i + 0.5 ) / 2.0 - 0.5,
+                                                ( j + 0.5 ) / 2.0 - 0.5 );
+    }
+  }
+
+  std::printf( "%-12s %14s %14s %14s %14s\n", "kernel", "points M/s",
+               "points rms", "2x M/s", "2x rms" );
+
+  std::vector<double> out( n );
+  double points = bench::measure( [&]() {
+      for( size_t i = 0; i < n; i++ ) {
+        out[i] = bicubic_at( image, size, x[i], y[i] );
+      }
+    }, n );
+  std::printf( "%-12s %14.2f %14.2e %14s %14s\n", "bicubic", points,
+               rms( out, expected ), "-", "-" );
+
+  using precision::sinc_weights;
+
+  run_sinc( "lanczos2", precision::lanczos2_kernel(), image, size,
+            x, y, expected, expected_2x );
+  run_sinc( "lanczos3", precision::lanczos3_kernel(), image, size,
+            x, y, expected, expected_2x );
+  run_sinc( "lanczos4", precision::lanczos4_kernel(), image, size,
+            x, y, expected, expected_2x );
+  run_sinc( "hann3", precision::sinc_kernel<3>( sinc_weights::HANN ), image,
+            size, x, y, expected, expected_2x );
+  run_sinc( "blackman4", precision::sinc_kernel<4>( sinc_weights::BLACKMAN ),
+            image, size, x, y, expected, expected_2x );
+
+  return 0;
+}
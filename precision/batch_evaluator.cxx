@@ -0,0 +1,311 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/batch_evaluator.hxx>
+#include <precision/evaluation_measurements.hxx>
+#include <precision/math.hxx>
+#include <precision/monotonic_arena.hxx>
+#include <precision/simd_kernels.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace precision {
+  namespace {
+    double now()
+    {
+      return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    bool is_estimator( batch_evaluator::stage s )
+    {
+      return s == batch_evaluator::LENGTH_VARIATION ||
+             s == batch_evaluator::ANISOMORPHISM ||
+             s == batch_evaluator::SIMILARITY;
+    }
+
+  }
+
+  /**
+   * State of one tie point set while the batch runs
+   */
+  struct batch_evaluator::job {
+    /**
+     * Partial result of one row band
+     */
+    struct band {
+      stage s; ///< Estimator.
+      size_t i_begin; ///< First row.
+      size_t i_end; ///< Row after the last.
+      bool ok; ///< If the kernel succeeded.
+      double sum; ///< Partial sum.
+      size_t invalid; ///< Pairs not used, for anisomorphism.
+      double busy; ///< Task run time, in seconds.
+    };
+
+    std::vector<tie_point>* set; ///< Tie point set.
+    result* res; ///< Result of the set.
+    const std::vector<stage>* pipeline; ///< Stages to run.
+    double max_dif; ///< Maximum difference for REMOVE_DUPLICATES.
+
+    monotonic_arena arena; ///< Memory of the coordinates.
+    size_t n; ///< Number of tie points, 0 until split.
+    double *x, *y, *u, *v; ///< Coordinates of the set.
+    size_t unique_n; ///< Number of unique tie points, 0 until split.
+    double *sx, *sy, *su, *sv; ///< Sorted and unique coordinates.
+
+    std::vector<band> bands; ///< Partial results.
+    std::atomic<size_t> remaining; ///< Tasks not finished.
+    double start; ///< Preparation start, in seconds.
+    double prepare_busy; ///< Preparation run time, in seconds.
+  };
+
+  batch_evaluator::batch_evaluator( size_t threads, size_t band_work )
+      :pool_( threads ), band_work_( band_work ? band_work : 1 )
+  {
+  }
+
+  batch_evaluator::~batch_evaluator()
+  {
+  }
+
+  bool batch_evaluator::run( std::vector< std::vector<tie_point> >& sets,
+                             const std::vector<stage>& pipeline,
+                             std::vector<result>& results,
+                             double max_dif )
+  {
+    bool estimating = false;
+    bool seen[SIMILARITY + 1] = { false };
+
+    for( size_t i = 0; i < pipeline.size(); i++ ) {
+      // A repeated estimator would add its bands twice to the same sum.
+      if( pipeline[i] > SIMILARITY || seen[pipeline[i]] ) {
+        return false;
+      }
+      seen[pipeline[i]] = true;
+
+      if( is_estimator( pipeline[i] ) ) {
+        estimating = true;
+      } else if( estimating ) {
+        return false;
+      }
+    }
+
+    results.assign( sets.size(), result() );
+
+    std::vector<job*> jobs( sets.size() );
+    std::vector< std::pair<size_t, size_t> > order( sets.size() );
+
+    for( size_t i = 0; i < sets.size(); i++ ) {
+      job* j = new job;
+      j->set = &sets[i];
+      j->res = &results[i];
+      j->pipeline = &pipeline;
+      j->max_dif = max_dif;
+      j->n = 0;
+      j->unique_n = 0;
+      j->remaining = 0;
+      j->start = 0.0;
+      j->prepare_busy = 0.0;
+      jobs[i] = j;
+
+      order[i] = std::make_pair( sets[i].size(), i );
+    }
+
+    // Largest sets first, the small ones fill the gaps at the end.
+    std::sort( order.rbegin(), order.rend() );
+
+    for( size_t i = 0; i < order.size(); i++ ) {
+      job* j = jobs[order[i].second];
+      pool_.submit( [this, j]() { prepare( j ); } );
+    }
+
+    pool_.wait();
+
+    for( size_t i = 0; i < jobs.size(); i++ ) {
+      delete jobs[i];
+    }
+
+    return true;
+  }
+
+  size_t batch_evaluator::get_threads() const
+  {
+    return pool_.get_threads();
+  }
+
+  void batch_evaluator::prepare( job* j )
+  {
+    j->start = now();
+
+    std::vector<tie_point>& set = *j->set;
+    result& res = *j->res;
+    const std::vector<stage>& pipeline = *j->pipeline;
+
+    for( size_t i = 0; i < pipeline.size(); i++ ) {
+      if( pipeline[i] == REMOVE_DUPLICATES ) {
+        tie_point::remove_duplicate_points( set, j->max_dif );
+      } else if( pipeline[i] == CHANGE_ORIGINS ) {
+        tie_point::compute_origins( set, res.xy0, res.uv0 );
+        tie_point::change_origins( set, res.xy0, res.uv0 );
+      } else if( pipeline[i] == LENGTH_VARIATION && !j->unique_n ) {
+        // Sorted and unique, as evaluation_measurements does.
+        tie_point_arena_vector unique(
+          ( arena_allocator<tie_point>( j->arena ) ) );
+        detail::unique_tie_points( set.begin(), set.end(), unique );
+
+        j->unique_n = unique.size();
+        detail::split_coordinates( unique.begin(), unique.size(), j->arena,
+                                   j->sx, j->sy, j->su, j->sv );
+      } else if( is_estimator( pipeline[i] ) && !j->n ) {
+        j->n = set.size();
+        detail::split_coordinates( set.begin(), set.size(), j->arena,
+                                   j->x, j->y, j->u, j->v );
+      }
+    }
+
+    for( size_t i = 0; i < pipeline.size(); i++ ) {
+      if( is_estimator( pipeline[i] ) ) {
+        split( j, pipeline[i] );
+      }
+    }
+
+    // The bands are final, count them before any of them can finish.
+    const size_t bands = j->bands.size();
+    j->remaining = bands + 1;
+    res.tasks = bands + 1;
+
+    for( size_t b = 0; b < bands; b++ ) {
+      pool_.submit( [this, j, b]() {
+          const job::band& band = j->bands[b];
+          estimate( j, band.s, b, band.i_begin, band.i_end );
+        } );
+    }
+
+    j->prepare_busy = now() - j->start;
+    finish_task( j );
+  }
+
+  void batch_evaluator::split( job* j, stage s )
+  {
+    const size_t n = ( s == LENGTH_VARIATION ) ? j->unique_n : j->n;
+    const size_t order = ( s == SIMILARITY ) ? 3 : 2;
+
+    if( n < order ) {
+      return;
+    }
+
+    // Row i holds the pairs (i, j > i), or the triplets (i, j > i, k > j).
+    size_t i_begin = 0;
+    double work = 0.0;
+
+    for( size_t i = 0; i < n; i++ ) {
+      const size_t rest = n - 1 - i;
+      if( rest >= order - 1 ) {
+        work += math::binomial_number( rest, order - 1 );
+      }
+
+      if( work >= band_work_ || i + 1 == n ) {
+        job::band b;
+        b.s = s;
+        b.i_begin = i_begin;
+        b.i_end = i + 1;
+        b.ok = true;
+        b.sum = 0.0;
+        b.invalid = 0;
+        b.busy = 0.0;
+        j->bands.push_back( b );
+
+        i_begin = i + 1;
+        work = 0.0;
+      }
+    }
+  }
+
+  void batch_evaluator::estimate( job* j, stage s, size_t band,
+                                  size_t i_begin, size_t i_end )
+  {
+    double start = now();
+    job::band& b = j->bands[band];
+
+    switch( s ) {
+    case LENGTH_VARIATION:
+      b.ok = simd_kernels::pairwise_length_ratio( j->sx, j->sy, j->su, j->sv,
+                                                  j->unique_n,
+                                                  i_begin, i_end, b.sum );
+      break;
+    case ANISOMORPHISM:
+      simd_kernels::pairwise_anisomorphism( j->x, j->y, j->u, j->v, j->n,
+                                            i_begin, i_end,
+                                            b.sum, b.invalid );
+      break;
+    case SIMILARITY:
+      b.ok = simd_kernels::triplet_angle_ratio( j->x, j->y, j->u, j->v, j->n,
+                                                i_begin, i_end, b.sum );
+      break;
+    default:
+      break;
+    }
+
+    b.busy = now() - start;
+    finish_task( j );
+  }
+
+  void batch_evaluator::finish_task( job* j )
+  {
+    double end = now();
+
+    if( --j->remaining != 0 ) {
+      return;
+    }
+
+    /* Last task of the set, combines the partial results */
+    result& res = *j->res;
+    const std::vector<stage>& pipeline = *j->pipeline;
+
+    double sum[SIMILARITY + 1] = { 0.0 };
+    size_t invalid = 0;
+    bool ok[SIMILARITY + 1] = { true, true, true, true, true };
+    bool present[SIMILARITY + 1] = { false };
+
+    res.busy = j->prepare_busy;
+    for( size_t b = 0; b < j->bands.size(); b++ ) {
+      const job::band& band = j->bands[b];
+
+      sum[band.s] += band.sum;
+      ok[band.s] = ok[band.s] && band.ok;
+      present[band.s] = true;
+      invalid += band.invalid;
+      res.busy += band.busy;
+    }
+
+    for( size_t i = 0; i < pipeline.size(); i++ ) {
+      stage s = pipeline[i];
+
+      // Estimators are present only for sets large enough for them.
+      if( s == LENGTH_VARIATION ) {
+        res.length_variation_ok = present[s] && ok[s];
+        res.length_variation = res.length_variation_ok ?
+          sum[s] / math::binomial_number( j->unique_n, 2 ) : 0.0;
+      } else if( s == ANISOMORPHISM ) {
+        res.anisomorphism_ok = present[s];
+        if( present[s] ) {
+          double den = math::binomial_number( j->n, 2 ) - invalid;
+          res.anisomorphism = ( den )? ( sum[s] / den ): 1.0;
+        } else {
+          res.anisomorphism = 0.0;
+        }
+      } else if( s == SIMILARITY ) {
+        res.similarity_ok = present[s] && ok[s];
+        res.similarity = res.similarity_ok ?
+          sum[s] / math::binomial_number( j->n, 3 ) : 0.0;
+      }
+    }
+
+    res.elapsed = end - j->start;
+  }
+}
@@ -0,0 +1,149 @@
+#ifndef PRECISION_BATCH_EVALUATOR_HXX
+#define PRECISION_BATCH_EVALUATOR_HXX
+
+#include <precision/point.hxx>
+#include <precision/tie_point.hxx>
+#include <precision/work_stealing_pool.hxx>
+
+#include <cstddef>
+#include <vector>
+
+namespace precision {
+  /**
+   * Runs a pipeline of tie point stages over many independent tie point sets
+   * on a precision::work_stealing_pool.
+   *
+   * Each set gets a preparation task, which runs the stages that change the
+   * set, and then estimation tasks. The pairwise estimators of a large set
+   * are split in row bands of its pair (or triplet) matrix with similar
+   * amounts of work, so a few huge sets do not leave workers idle behind
+   * them.
+   *
+   * Results are the ones of precision::tie_point and
+   * precision::evaluation_measurements, up to the rounding of the partial
+   * sums.
+   */
+  class batch_evaluator {
+  public:
+    /**
+     * Pipeline stage
+     */
+    enum stage {
+      REMOVE_DUPLICATES = 0, ///< tie_point::remove_duplicate_points
+      CHANGE_ORIGINS,        ///< tie_point::compute_origins and change_origins
+      LENGTH_VARIATION,      ///< evaluation_measurements::estimate_length_var
+      ANISOMORPHISM,     ///< evaluation_measurements::estimate_anisomorphism
+      SIMILARITY         ///< evaluation_measurements::estimate_similarity
+    };
+
+    /**
+     * Result of one tie point set
+     */
+    struct result {
+      bool length_variation_ok; ///< If length variation was estimated.
+      bool anisomorphism_ok; ///< If anisomorphism was estimated.
+      bool similarity_ok; ///< If similarity was estimated.
+
+      double length_variation; ///< Length variation measurement.
+      double anisomorphism; ///< Anisomorphism measurement.
+      double similarity; ///< Similarity measurement.
+
+      point xy0; ///< Work-points origin, if origins were changed.
+      point uv0; ///< Reference-points origin, if origins were changed.
+
+      size_t tasks; ///< Number of tasks the set was split in.
+      double elapsed; ///< Seconds from the first task start to the last end.
+      double busy; ///< Seconds spent running the tasks of the set.
+    };
+
+    /**
+     * Default constructor.
+     *
+     * @param threads Number of workers, 0 for one per hardware thread.
+     * @param band_work Pairs (or triplets) evaluated by one task; larger
+     *                  sets are split.
+     */
+    explicit batch_evaluator( size_t threads = 0,
+                              size_t band_work = 1 << 18 );
+
+    /**
+     * Default destructor.
+     */
+    ~batch_evaluator();
+
+    /**
+     * Runs a pipeline over tie point sets and waits for the results.
+     *
+     * Stages that change the sets must come before the estimators, and
+     * every stage may appear only once.
+     *
+     * @param sets Tie point sets, changed by REMOVE_DUPLICATES and
+     *             CHANGE_ORIGINS.
+     * @param pipeline Stages to run on every set, in order.
+     * @param results One result per set.
+     * @param max_dif Maximum difference for REMOVE_DUPLICATES.
+     * @return true if sucess, false if the pipeline order is invalid or a
+     *         stage is repeated
+     */
+    bool run( std::vector< std::vector<tie_point> >& sets,
+              const std::vector<stage>& pipeline,
+              std::vector<result>& results,
+              double max_dif = 0.0 );
+
+    /**
+     * Returns the number of workers.
+     *
+     * @return Number of workers.
+     */
+    size_t get_threads() const;
+
+  private:
+    struct job;
+
+    /**
+     * Runs the preparation of a set and queues its estimation tasks.
+     *
+     * @param j Set job.
+     */
+    void prepare( job* j );
+
+    /**
+     * Splits one estimator in row bands of similar work.
+     *
+     * @param j Set job.
+     * @param s Estimator stage.
+     */
+    void split( job* j, stage s );
+
+    /**
+     * Runs one row band of an estimator.
+     *
+     * @param j Set job.
+     * @param s Estimator stage.
+     * @param band Band index in the job partial results.
+     * @param i_begin First row.
+     * @param i_end Row after the last.
+     */
+    void estimate( job* j, stage s, size_t band,
+                   size_t i_begin, size_t i_end );
+
+    /**
+     * Accounts a finished task and, for the last task of a set, combines
+     * the partial results.
+     *
+     * @param j Set job.
+     */
+    void finish_task( job* j );
+
+    /// Undefined copy constructor.
+    batch_evaluator( const batch_evaluator& );
+
+    /// Undefined assignment operator.
+    batch_evaluator& operator = ( const batch_evaluator& );
+
+    work_stealing_pool pool_; ///< Workers.
+    size_t band_work_; ///< Work of one task.
+  };
+}
+
+#endif // PRECISION_BATCH_EVALUATOR_HXX
@@ -0,0 +1,138 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/cpu_dispatch.hxx>
+#include <precision/simd_kernels_impl.hxx>
+
+#include <atomic>
+#include <cstdlib>
+
+namespace precision {
+  namespace {
+    /// Level used by the kernels.
+    std::atomic<int> active_level( -1 );
+
+    cpu_dispatch::level detect_level()
+    {
+#ifdef PRECISION_X86_DISPATCH
+      // __builtin_cpu_supports checks cpuid and the OS support for the
+      // extended register state.
+      __builtin_cpu_init();
+
+      if( __builtin_cpu_supports( "avx512f" ) ) {
+        return cpu_dispatch::AVX512;
+      }
+      if( __builtin_cpu_supports( "avx2" ) &&
+          __builtin_cpu_supports( "fma" ) ) {
+        return cpu_dispatch::AVX2;
+      }
+#endif
+      return cpu_dispatch::GENERIC;
+    }
+
+    cpu_dispatch::level select_level()
+    {
+      cpu_dispatch::level best = cpu_dispatch::get_best_level();
+      cpu_dispatch::level forced;
+
+      const char* env = std::getenv( "PRECISION_CPU_LEVEL" );
+      if( env && cpu_dispatch::from_string( env, forced ) &&
+          forced < best ) {
+        return forced;
+      }
+
+      return best;
+    }
+
+    /// Selects the level when the library is loaded.
+    struct load_time_selection {
+      load_time_selection() {
+        cpu_dispatch::reset_level();
+      }
+    } selection;
+  }
+
+  cpu_dispatch::level cpu_dispatch::get_level()
+  {
+    int l = active_level.load( std::memory_order_relaxed );
+
+    if( l < 0 ) {
+      l = select_level();
+      active_level.store( l, std::memory_order_relaxed );
+    }
+
+    return static_cast<level>( l );
+  }
+
+  cpu_dispatch::level cpu_dispatch::get_best_level()
+  {
+    static const level best = detect_level();
+    return best;
+  }
+
+  bool cpu_dispatch::is_supported( level l )
+  {
+    return l >= GENERIC && l <= get_best_level();
+  }
+
+  bool cpu_dispatch::set_level( level l )
+  {
+    if( !is_supported( l ) ) {
+      return false;
+    }
+
+    active_level.store( l, std::memory_order_relaxed );
+    return true;
+  }
+
+  void cpu_dispatch::reset_level()
+  {
+    active_level.store( select_level(), std::memory_order_relaxed );
+  }
+
+  const char* cpu_dispatch::to_string( level l )
+  {
+    switch( l ) {
+    case AVX2:
+      return "avx2";
+    case AVX512:
+      return "avx512";
+    default:
+      return "generic";
+    }
+  }
+
+  bool cpu_dispatch::from_string( const std::string& name, level& l )
+  {
+    if( name == "generic" ) {
+      l = GENERIC;
+    } else if( name == "avx2" ) {
+      l = AVX2;
+    } else if( name == "avx512" ) {
+      l = AVX512;
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
+  namespace detail {
+
+    const simd_kernel_table& active_kernels()
+    {
+      switch( cpu_dispatch::get_level() ) {
+#ifdef PRECISION_X86_DISPATCH
+      case cpu_dispatch::AVX512:
+        return avx512_kernels();
+      case cpu_dispatch::AVX2:
+        return avx2_kernels();
+#endif
+      default:
+        return generic_kernels();
+      }
+    }
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef PRECISION_CPU_DISPATCH_HXX
+#define PRECISION_CPU_DISPATCH_HXX
+
+#include <string>
+
+namespace precision {
+  /**
+   * Runtime selection of the instruction set used by the SIMD kernels.
+   *
+   * The library carries one build of each hot kernel per instruction set
+   * level. The best level supported by the running CPU is chosen once, when
+   * the library is loaded. It can be forced with the PRECISION_CPU_LEVEL
+   * environment variable ("generic", "avx2" or "avx512") or with set_level().
+   *
+   * All methods are static.
+   * To prevent instantiation, constructor is private.
+   */
+  class cpu_dispatch {
+  public:
+    /**
+     * Instruction set level
+     */
+    enum level {
+      GENERIC = 0, ///< Baseline build, no extension required.
+      AVX2,        ///< AVX2 and FMA.
+      AVX512       ///< AVX-512 Foundation.
+    };
+
+    /**
+     * Returns the level used by the kernels.
+     *
+     * @return Active level.
+     */
+    static level get_level();
+
+    /**
+     * Returns the best level supported by the running CPU.
+     *
+     * @return Best supported level.
+     */
+    static level get_best_level();
+
+    /**
+     * Check if a level is supported by the running CPU and by this build.
+     *
+     * @param l Level to check.
+     * @return True if the kernels can run at @p l.
+     */
+    static bool is_supported( level l );
+
+    /**
+     * Forces the kernels to run at a level.
+     *
+     * This is meant for testing and benchmarking. It must not be called
+     * while kernels are running on other threads.
+     *
+     * @param l Level to use.
+     * @return True if success, false if @p l is not supported.
+     */
+    static bool set_level( level l );
+
+    /**
+     * Selects the level again from the CPU and the environment.
+     */
+    static void reset_level();
+
+    /**
+     * Returns the name of a level.
+     *
+     * @param l Level.
+     * @return Level name.
+     */
+    static const char* to_string( level l );
+
+    /**
+     * Parses a level name, as accepted by PRECISION_CPU_LEVEL.
+     *
+     * @param name Level name.
+     * @param l Parsed level.
+     * @return True if success, false if @p name is unknown.
+     */
+    static bool from_string( const std::string& name, level& l );
+
+  private:
+      /// Undefined constructor.
+      cpu_dispatch();
+  };
+}
+
+#endif // PRECISION_CPU_DISPATCH_HXX
@@ -0,0 +1,346 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/cross_validation.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace precision {
+  namespace {
+    /// Largest number of parameters per axis.
+    const size_t MAX_PARAMETERS = 6;
+
+    /// Leverages closer to 1 leave the point out of the validation.
+    const double LEVERAGE_LIMIT = 1.0 - 1e-10;
+
+    bool is_control( tie_point::type t )
+    {
+      return t == tie_point::CONTROL || t == tie_point::CONTROL_CHECK;
+    }
+
+    /**
+     * In-place Cholesky decomposition, m = l * l^T, of a symmetric
+     * positive definite matrix stored row by row. Only the lower triangle
+     * is used and overwritten.
+     *
+     * @return false if the matrix is singular.
+     */
+    bool cholesky( double* m, size_t p )
+    {
+      double max_diagonal = 0.0;
+      for( size_t i = 0; i < p; i++ ) {
+        max_diagonal = std::max( max_diagonal, m[i * p + i] );
+      }
+
+      for( size_t j = 0; j < p; j++ ) {
+        double d = m[j * p + j];
+        for( size_t k = 0; k < j; k++ ) {
+          d -= m[j * p + k] * m[j * p + k];
+        }
+
+        if( d <= max_diagonal * 1e-12 ) {
+          return false;
+        }
+
+        d = std::sqrt( d );
+        m[j * p + j] = d;
+
+        for( size_t i = j + 1; i < p; i++ ) {
+          double s = m[i * p + j];
+          for( size_t k = 0; k < j; k++ ) {
+            s -= m[i * p + k] * m[j * p + k];
+          }
+          m[i * p + j] = s / d;
+        }
+      }
+
+      return true;
+    }
+
+    /**
+     * Solves l * z = b, with l from cholesky().
+     */
+    void forward_substitution( const double* l, size_t p,
+                               const double* b, double* z )
+    {
+      for( size_t i = 0; i < p; i++ ) {
+        double s = b[i];
+        for( size_t k = 0; k < i; k++ ) {
+          s -= l[i * p + k] * z[k];
+        }
+        z[i] = s / l[i * p + i];
+      }
+    }
+
+    /**
+     * Solves l^T * x = z, with l from cholesky().
+     */
+    void backward_substitution( const double* l, size_t p,
+                                const double* z, double* x )
+    {
+      for( size_t i = p; i-- > 0; ) {
+        double s = z[i];
+        for( size_t k = i + 1; k < p; k++ ) {
+          s -= l[k * p + i] * x[k];
+        }
+        x[i] = s / l[i * p + i];
+      }
+    }
+
+    double dot( const double* a, const double* b, size_t p )
+    {
+      double s = 0.0;
+      for( size_t i = 0; i < p; i++ ) {
+        s += a[i] * b[i];
+      }
+      return s;
+    }
+  }
+
+  cross_validation::cross_validation( transform t, double demote_factor,
+                                      double drop_factor, double tolerance )
+      :transform_( t ), demote_factor_( demote_factor ),
+       drop_factor_( drop_factor ), tolerance_( tolerance ),
+       loo_rmse_( 0.0 ), loo_median_( 0.0 )
+  {
+  }
+
+  cross_validation::~cross_validation()
+  {
+  }
+
+  bool cross_validation::evaluate( const std::vector<tie_point>& tie_points )
+  {
+    const size_t p = parameters();
+    const size_t n = tie_points.size();
+
+    residuals_.clear();
+    coefficients_u_.clear();
+    coefficients_v_.clear();
+    loo_rmse_ = 0.0;
+    loo_median_ = 0.0;
+
+    /* Normalizes coordinates around the control points centroid */
+    double x0 = 0.0, y0 = 0.0, u0 = 0.0, v0 = 0.0;
+    size_t n_control = 0;
+
+    for( size_t i = 0; i < n; i++ ) {
+      if( is_control( tie_points[i].get_type() ) ) {
+        point x_y, u_v;
+        tie_points[i].get( x_y, u_v );
+
+        x0 += x_y.get_x();
+        y0 += x_y.get_y();
+        u0 += u_v.get_x();
+        v0 += u_v.get_y();
+        n_control++;
+      }
+    }
+
+    if( n_control <= p ) {
+      return false;
+    }
+
+    x0 /= n_control;
+    y0 /= n_control;
+    u0 /= n_control;
+    v0 /= n_control;
+
+    double scale = 0.0;
+    for( size_t i = 0; i < n; i++ ) {
+      if( is_control( tie_points[i].get_type() ) ) {
+        point x_y = tie_points[i].get_xy();
+        scale = std::max( scale, std::fabs( x_y.get_x() - x0 ) );
+        scale = std::max( scale, std::fabs( x_y.get_y() - y0 ) );
+      }
+    }
+    if( scale == 0.0 ) {
+      return false;
+    }
+
+    /* Normal equations over the control points */
+    double normal[MAX_PARAMETERS * MAX_PARAMETERS] = { 0.0 };
+    double b_u[MAX_PARAMETERS] = { 0.0 };
+    double b_v[MAX_PARAMETERS] = { 0.0 };
+    double row[MAX_PARAMETERS];
+
+    for( size_t i = 0; i < n; i++ ) {
+      if( is_control( tie_points[i].get_type() ) ) {
+        point x_y, u_v;
+        tie_points[i].get( x_y, u_v );
+
+        design_row( ( x_y.get_x() - x0 ) / scale,
+                    ( x_y.get_y() - y0 ) / scale, row );
+        double du = u_v.get_x() - u0;
+        double dv = u_v.get_y() - v0;
+
+        for( size_t r = 0; r < p; r++ ) {
+          for( size_t c = 0; c <= r; c++ ) {
+            normal[r * p + c] += row[r] * row[c];
+          }
+          b_u[r] += row[r] * du;
+          b_v[r] += row[r] * dv;
+        }
+      }
+    }
+
+    if( !cholesky( normal, p ) ) {
+      return false;
+    }
+
+    double z[MAX_PARAMETERS];
+    coefficients_u_.resize( p );
+    coefficients_v_.resize( p );
+
+    forward_substitution( normal, p, b_u, z );
+    backward_substitution( normal, p, z, &coefficients_u_[0] );
+    forward_substitution( normal, p, b_v, z );
+    backward_substitution( normal, p, z, &coefficients_v_[0] );
+
+    /* Residuals and leave-one-out residuals */
+    std::vector<double> loo_lengths;
+    loo_lengths.reserve( n_control );
+    residuals_.resize( n );
+
+    for( size_t i = 0; i < n; i++ ) {
+      point x_y, u_v;
+      tie_points[i].get( x_y, u_v );
+
+      design_row( ( x_y.get_x() - x0 ) / scale,
+                  ( x_y.get_y() - y0 ) / scale, row );
+
+      residual& res = residuals_[i];
+      res.u = ( u_v.get_x() - u0 ) - dot( row, &coefficients_u_[0], p );
+      res.v = ( u_v.get_y() - v0 ) - dot( row, &coefficients_v_[0], p );
+      res.loo_u = res.u;
+      res.loo_v = res.v;
+      res.leverage = 0.0;
+      res.recommended = KEEP;
+
+      if( is_control( tie_points[i].get_type() ) ) {
+        // h = row^T ( A^T A )^-1 row = | l^-1 row |^2
+        forward_substitution( normal, p, row, z );
+        res.leverage = dot( z, z, p );
+
+        if( res.leverage < LEVERAGE_LIMIT ) {
+          res.loo_u = res.u / ( 1.0 - res.leverage );
+          res.loo_v = res.v / ( 1.0 - res.leverage );
+          loo_lengths.push_back( std::sqrt( res.loo_u * res.loo_u +
+                                            res.loo_v * res.loo_v ) );
+        } else {
+          // The point alone determines part of the fit.
+          res.loo_u = std::numeric_limits<double>::quiet_NaN();
+          res.loo_v = std::numeric_limits<double>::quiet_NaN();
+        }
+      }
+    }
+
+    if( loo_lengths.empty() ) {
+      return true;
+    }
+
+    double sum = 0.0;
+    for( size_t i = 0; i < loo_lengths.size(); i++ ) {
+      sum += loo_lengths[i] * loo_lengths[i];
+    }
+    loo_rmse_ = std::sqrt( sum / loo_lengths.size() );
+
+    std::vector<double>::iterator middle =
+      loo_lengths.begin() + loo_lengths.size() / 2;
+    std::nth_element( loo_lengths.begin(), middle, loo_lengths.end() );
+    loo_median_ = *middle;
+
+    /* Recommendations, never below the tolerance: on an exact fit the
+       median is rounding noise */
+    const double drop = std::max( drop_factor_ * loo_median_, tolerance_ );
+    const double demote = std::max( demote_factor_ * loo_median_, tolerance_ );
+
+    for( size_t i = 0; i < n; i++ ) {
+      residual& res = residuals_[i];
+
+      // NaN lengths compare false, those points are kept.
+      double length = std::sqrt( res.loo_u * res.loo_u +
+                                 res.loo_v * res.loo_v );
+
+      if( length > drop ) {
+        res.recommended = DROP;
+      } else if( length > demote &&
+                 is_control( tie_points[i].get_type() ) ) {
+        res.recommended = DEMOTE_TO_CHECK;
+      }
+    }
+
+    return true;
+  }
+
+  bool cross_validation::apply( std::vector<tie_point>& tie_points ) const
+  {
+    if( tie_points.size() != residuals_.size() ) {
+      return false;
+    }
+
+    size_t kept = 0;
+    for( size_t i = 0; i < tie_points.size(); i++ ) {
+      if( residuals_[i].recommended == DROP ) {
+        continue;
+      }
+
+      tie_points[kept] = tie_points[i];
+      if( residuals_[i].recommended == DEMOTE_TO_CHECK ) {
+        tie_points[kept].set_type( tie_point::CHECK );
+      }
+      kept++;
+    }
+    tie_points.resize( kept );
+
+    return true;
+  }
+
+  const std::vector<cross_validation::residual>&
+  cross_validation::get_residuals() const
+  {
+    return residuals_;
+  }
+
+  double cross_validation::get_loo_rmse() const
+  {
+    return loo_rmse_;
+  }
+
+  double cross_validation::get_loo_median() const
+  {
+    return loo_median_;
+  }
+
+  const std::vector<double>& cross_validation::get_coefficients_u() const
+  {
+    return coefficients_u_;
+  }
+
+  const std::vector<double>& cross_validation::get_coefficients_v() const
+  {
+    return coefficients_v_;
+  }
+
+  size_t cross_validation::parameters() const
+  {
+    return ( transform_ == POLYNOMIAL_2 ) ? 6 : 3;
+  }
+
+  void cross_validation::design_row( double x, double y, double* row ) const
+  {
+    row[0] = 1.0;
+    row[1] = x;
+    row[2] = y;
+
+    if( transform_ == POLYNOMIAL_2 ) {
+      row[3] = x * y;
+      row[4] = x * x;
+      row[5] = y * y;
+    }
+  }
+}
@@ -0,0 +1,184 @@
+#ifndef PRECISION_CROSS_VALIDATION_HXX
+#define PRECISION_CROSS_VALIDATION_HXX
+
+#include <precision/tie_point.hxx>
+
+#include <cstddef>
+#include <vector>
+
+namespace precision {
+  /**
+   * Leave-one-out cross-validation of tie points.
+   *
+   * A linear-in-parameters transformation from work (x,y) to reference (u,v)
+   * coordinates is fitted once, by least squares, over the CONTROL and
+   * CONTROL_CHECK points. The leave-one-out residual of each of these points
+   * is derived from the full fit through the hat matrix diagonal h:
+   *
+   *   loo = residual / ( 1 - h )
+   *
+   * so the whole evaluation is O(n) instead of n refits. CHECK and NONE
+   * points are not fitted, their residual is the prediction error.
+   *
+   * Points whose leave-one-out residual is far from the median, and above
+   * an absolute tolerance, are recommended to be demoted to CHECK or
+   * dropped. The tolerance keeps rounding noise of exact fits from being
+   * taken for outliers.
+   */
+  class cross_validation {
+  public:
+    /**
+     * Fitted transformation
+     */
+    enum transform {
+      AFFINE = 0,  ///< u = a0 + a1 x + a2 y, 3 parameters per axis.
+      POLYNOMIAL_2 ///< Second order polynomial, 6 parameters per axis.
+    };
+
+    /**
+     * Recommendation for a tie point
+     */
+    enum action {
+      KEEP = 0,
+      DEMOTE_TO_CHECK,
+      DROP
+    };
+
+    /**
+     * Cross-validation result of one tie point
+     */
+    struct residual {
+      double u; ///< Residual in u, reference minus fitted.
+      double v; ///< Residual in v, reference minus fitted.
+      double loo_u; ///< Leave-one-out residual in u.
+      double loo_v; ///< Leave-one-out residual in v.
+      double leverage; ///< Hat matrix diagonal, 0 if not fitted.
+      action recommended; ///< Recommendation for the point.
+    };
+
+    /**
+     * Default constructor.
+     *
+     * @param t Fitted transformation.
+     * @param demote_factor Control points with a leave-one-out residual
+     *                      length above demote_factor times the median are
+     *                      recommended to be demoted to CHECK.
+     * @param drop_factor Points with a leave-one-out residual length above
+     *                    drop_factor times the median are recommended to be
+     *                    dropped.
+     * @param tolerance Leave-one-out residual length, in reference
+     *                  coordinates, below which points are always kept.
+     */
+    explicit cross_validation( transform t = AFFINE,
+                               double demote_factor = 3.0,
+                               double drop_factor = 5.0,
+                               double tolerance = 1e-6 );
+
+    /**
+     * Default destructor.
+     */
+    ~cross_validation();
+
+    /**
+     * Fits the transformation and computes every residual.
+     *
+     * @param tie_points User Tie Points
+     * @return true if sucess, false if there are not enough control points
+     *         or they do not determine the transformation
+     */
+    bool evaluate( const std::vector<tie_point>& tie_points );
+
+    /**
+     * Applies the recommendations: demotes points to CHECK and removes
+     * dropped points.
+     *
+     * @param tie_points Tie points given to evaluate().
+     * @return true if sucess, false if @p tie_points size differs from the
+     *         evaluated one
+     */
+    bool apply( std::vector<tie_point>& tie_points ) const;
+
+    /**
+     * Returns the residuals, in the order of the evaluated tie points.
+     *
+     * @return residuals_
+     */
+    const std::vector<residual>& get_residuals() const;
+
+    /**
+     * Returns the root mean square of the control points leave-one-out
+     * residual lengths.
+     *
+     * @return loo_rmse_
+     */
+    double get_loo_rmse() const;
+
+    /**
+     * Returns the median of the control points leave-one-out residual
+     * lengths, the scale of the recommendation thresholds.
+     *
+     * @return loo_median_
+     */
+    double get_loo_median() const;
+
+    /**
+     * Returns the fitted coefficients for u, in normalized coordinates.
+     *
+     * @return coefficients_u_
+     */
+    const std::vector<double>& get_coefficients_u() const;
+
+    /**
+     * Returns the fitted coefficients for v, in normalized coordinates.
+     *
+     * @return coefficients_v_
+     */
+    const std::vector<double>& get_coefficients_v() const;
+
+  private:
+    /**
+     * Number of parameters per axis of the transformation.
+     *
+     * @return Number of parameters.
+     */
+    size_t parameters() const;
+
+    /**
+     * Fills the design matrix row of a normalized work point.
+     *
+     * @param x Normalized x.
+     * @param y Normalized y.
+     * @param row Row, with parameters() elements.
+     */
+    void design_row( double x, double y, double* row ) const;
+
+    /// Fitted transformation
+    transform transform_;
+
+    /// Demote threshold, relative to loo_median_
+    double demote_factor_;
+
+    /// Drop threshold, relative to loo_median_
+    double drop_factor_;
+
+    /// Smallest demote and drop threshold
+    double tolerance_;
+
+    /// Residuals of the evaluated tie points
+    std::vector<residual> residuals_;
+
+    /// Fitted coefficients for u
+    std::vector<double> coefficients_u_;
+
+    /// Fitted coefficients for v
+    std::vector<double> coefficients_v_;
+
+    /// Leave-one-out RMSE of the control points
+    double loo_rmse_;
+
+    /// Leave-one-out median of the control points
+    double loo_median_;
+  };
+}
+
+#endif // PRECISION_CROSS_VALIDATION_HXX
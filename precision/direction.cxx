@@ -0,0 +1,55 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/direction.hxx>
+
+#include <cmath>
+#include <limits>
+
+namespace precision {
+
+  double direction::length() const
+  {
+    if( length_ < 0.0 ) {
+      length_ = std::sqrt( squared_length() );
+    }
+
+    return length_;
+  }
+
+  bool direction::angle( const direction& d, double& a ) const
+  {
+    if( is_null() || d.is_null() ) {
+      return false;
+    }
+
+    // Unlike acos of the normalized dot product, no square root is needed
+    // and angles near 0 or pi keep their precision.
+    a = std::atan2( std::fabs( cross( d ) ), dot( d ) );
+    return true;
+  }
+
+  void direction::lengths( const direction* d, double* out, size_t n )
+  {
+    for( size_t i = 0; i < n; i++ ) {
+      out[i] = d[i].length();
+    }
+  }
+
+  size_t direction::angles( const direction* a, const direction* b,
+                            double* out, size_t n )
+  {
+    size_t null = 0;
+
+    for( size_t i = 0; i < n; i++ ) {
+      if( !a[i].angle( b[i], out[i] ) ) {
+        out[i] = std::numeric_limits<double>::quiet_NaN();
+        null++;
+      }
+    }
+
+    return null;
+  }
+}
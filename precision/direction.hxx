@@ -0,0 +1,175 @@
+#ifndef PRECISION_DIRECTION_HXX
+#define PRECISION_DIRECTION_HXX
+
+#include <precision/point.hxx>
+
+#include <cstddef>
+
+namespace precision {
+  /**
+   * Compact 2D vector.
+   *
+   * Stores only the deltas between two points and caches its length once
+   * computed. Unlike precision::vector it never throws: a direction between
+   * two equal points is null, which setters and angle() report by returning
+   * false.
+   *
+   * The length cache is filled by const methods, so a direction shared
+   * between threads must have its length computed before.
+   */
+  class direction {
+  public:
+    /**
+     * Default constructor, builds a null direction.
+     */
+    direction()
+        :dx_( 0.0 ), dy_( 0.0 ), length_( 0.0 ) {
+    }
+
+    /**
+     * Constructor from deltas.
+     *
+     * @param dx Delta in x axis.
+     * @param dy Delta in y axis.
+     */
+    direction( double dx, double dy )
+        :dx_( dx ), dy_( dy ), length_( -1.0 ) {
+    }
+
+    /**
+     * Constructor from points, null if the points are equal.
+     *
+     * @param p1 Start point.
+     * @param p2 End point.
+     */
+    direction( const point& p1, const point& p2 )
+        :dx_( p2.get_x() - p1.get_x() ), dy_( p2.get_y() - p1.get_y() ),
+         length_( -1.0 ) {
+    }
+
+    /**
+     * Direction from @p p1 to @p p2.
+     *
+     * @param p1 Start point.
+     * @param p2 End point.
+     * @return true if sucess, false if the points are equal and the
+     *         direction is null
+     */
+    bool set( const point& p1, const point& p2 ) {
+      set( p2.get_x() - p1.get_x(), p2.get_y() - p1.get_y() );
+      return p1 != p2;
+    }
+
+    /**
+     * Deltas setting.
+     *
+     * @param dx Delta in x axis.
+     * @param dy Delta in y axis.
+     */
+    void set( double dx, double dy ) {
+      dx_ = dx;
+      dy_ = dy;
+      length_ = -1.0;
+    }
+
+    /**
+     * Returns the delta in x axis.
+     * @return Delta in x axis.
+     */
+    inline double get_dx() const {
+      return dx_;
+    }
+
+    /**
+     * Returns the delta in y axis.
+     * @return Delta in y axis.
+     */
+    inline double get_dy() const {
+      return dy_;
+    }
+
+    /**
+     * Check if direction is null.
+     *
+     * @return True if both deltas are 0.
+     */
+    inline bool is_null() const {
+      return dx_ == 0.0 && dy_ == 0.0;
+    }
+
+    /**
+     * Returns the squared length.
+     *
+     * @return Squared length.
+     */
+    inline double squared_length() const {
+      return dx_ * dx_ + dy_ * dy_;
+    }
+
+    /**
+     * Returns the length, computed on the first call.
+     *
+     * @return Length.
+     */
+    double length() const;
+
+    /**
+     * Dot product.
+     *
+     * @param d Another direction.
+     * @return Dot product.
+     */
+    inline double dot( const direction& d ) const {
+      return dx_ * d.dx_ + dy_ * d.dy_;
+    }
+
+    /**
+     * Z component of the cross product, positive if @p d is
+     * counterclockwise from this direction.
+     *
+     * @param d Another direction.
+     * @return Cross product.
+     */
+    inline double cross( const direction& d ) const {
+      return dx_ * d.dy_ - dy_ * d.dx_;
+    }
+
+    /**
+     * Computes the angle between two directions, from
+     * atan2( |cross|, dot ), in [0, pi].
+     *
+     * @param d Another direction.
+     * @param a Angle in radians.
+     * @return true if sucess, false if one of the directions is null
+     */
+    bool angle( const direction& d, double& a ) const;
+
+    /**
+     * Computes the lengths of an array of directions.
+     *
+     * @param d Directions.
+     * @param out Lengths.
+     * @param n Number of directions.
+     */
+    static void lengths( const direction* d, double* out, size_t n );
+
+    /**
+     * Computes the angles between two arrays of directions.
+     *
+     * @param a First directions.
+     * @param b Second directions.
+     * @param out Angles in radians, NaN where one of the directions is null.
+     * @param n Number of directions.
+     * @return Number of pairs with a null direction.
+     */
+    static size_t angles( const direction* a, const direction* b,
+                          double* out, size_t n );
+
+  private:
+    double dx_; ///< Delta in x axis
+    double dy_; ///< Delta in y axis
+    mutable double length_; ///< Cached length, negative if not computed
+  };
+}
+
+#endif // PRECISION_DIRECTION_HXX
@@ -5,12 +5,24 @@
 
 #include <precision/evaluation_measurements.hxx>
 #include <precision/math.hxx>
-#include <precision/vector.hxx>
+#include <precision/simd_kernels.hxx>
 
 #include <cmath>
-#include <set>
 
 namespace precision {
+  namespace {
+    /**
+     * Arena size that fits the temporaries of the estimators, so the
+     * overloads without an arena ask the system for memory only once.
+     *
+     * @param n Number of tie points.
+     * @return Arena block size in bytes.
+     */
+    size_t arena_size( size_t n )
+    {
+      return n * ( sizeof( tie_point ) + 4 * sizeof( double ) ) + 64;
+    }
+  }
 
   evaluation_measurements::evaluation_measurements()
   {
@@ -27,157 +39,79 @@ namespace precision {
   bool evaluation_measurements::estimate_length_var(
     const std::list<tie_point>& tie_points )
   {
-    std::set<tie_point> tp( tie_points.begin(), tie_points.end());
-    std::set<tie_point>::const_iterator tpi_iterator, tpj_iterator;
+    monotonic_arena arena( arena_size( tie_points.size() ) );
+    return estimate_length_var( tie_points, arena );
+  }
 
-    if( tp.size() < 2 ) {
-      return false;
-    }
+  bool evaluation_measurements::estimate_anisomorphism(
+    const std::list<tie_point>& tie_points )
+  {
+    monotonic_arena arena( arena_size( tie_points.size() ) );
+    return estimate_anisomorphism( tie_points, arena );
+  }
 
-    point x_y_i, u_v_i;
-    point x_y_j, u_v_j;
+  bool evaluation_measurements::estimate_similarity(
+    const std::list<tie_point>& tie_points )
+  {
+    monotonic_arena arena( arena_size( tie_points.size() ) );
+    return estimate_similarity( tie_points, arena );
+  }
 
-    double den;
+  bool evaluation_measurements::compute_length_var(
+    const double* x, const double* y, const double* u, const double* v,
+    size_t n )
+  {
+    double den, sum;
 
     /* Estimates the length variation measurement */
     length_variation_ = 0.0;
-    unsigned list_size = tp.size();
-    den =  math::binomial_number( list_size, 2 );
-    tpi_iterator = tp.begin();
-    for( unsigned i = 0; i < list_size - 1; i++ ) {
-      ( *tpi_iterator ).get( x_y_i, u_v_i );
+    den =  math::binomial_number( n, 2 );
 
-      tpj_iterator = tpi_iterator;
-      for( unsigned j = ( i + 1 ); j < list_size; j++ ) {
-
-        tpj_iterator++;
-
-        ( *tpj_iterator ).get( x_y_j, u_v_j );
-
-        if( x_y_i == x_y_j || u_v_i == u_v_j ) {
-          return false;
-        }
-        precision::vector v_xy( x_y_i, x_y_j );
-        precision::vector v_uv( u_v_i, u_v_j );
-
-        length_variation_ += ( v_xy.length_vector() / v_uv.length_vector() ) /den ;
-      }
-
-      tpi_iterator++;
+    if( !simd_kernels::pairwise_length_ratio( x, y, u, v, n, sum ) ) {
+      return false;
     }
 
+    length_variation_ = sum / den;
+
     return true;
   }
 
-  bool evaluation_measurements::estimate_anisomorphism(
-    const std::list<tie_point>& tie_points )
+  bool evaluation_measurements::compute_anisomorphism(
+    const double* x, const double* y, const double* u, const double* v,
+    size_t n )
   {
-    std::list<tie_point> tp;
-
-    tp = tie_points;
-
-    if( tp.size() < 2 ) {
-      return false;
-    }
-
-    std::list<tie_point>::iterator tpi_iterator, tpj_iterator;
-
-    point x_y_i, u_v_i;
-    point x_y_j, u_v_j;
-
-    double num_1, den_1, num_2, den_2, den, sum;
+    double den, sum;
+    size_t invalid;
 
     /* Estimates the anisomorphism measurement */
-    unsigned list_size = tp.size();
-    den = math::binomial_number( list_size, 2 );
-
-    tpi_iterator = tp.begin();
-    sum = 0.0;
-    for( unsigned i = 0; i < list_size - 1; i++ ) {
-
-      ( *tpi_iterator ).get( x_y_i, u_v_i );
-
-      tpj_iterator = tpi_iterator;
-      for( unsigned j = ( i + 1 ); j < list_size; j++ ) {
-
-        tpj_iterator++;
-
-        ( *tpj_iterator ).get( x_y_j, u_v_j );
+    den = math::binomial_number( n, 2 );
 
-        num_1 = std::fabs( x_y_i.get_x() - x_y_j.get_x() );
-        den_1 = std::fabs( u_v_i.get_x() - u_v_j.get_x() );
+    simd_kernels::pairwise_anisomorphism( x, y, u, v, n, sum, invalid );
 
-        num_2 = std::fabs( x_y_i.get_y() - x_y_j.get_y() );
-        den_2 = std::fabs( u_v_i.get_y() - u_v_j.get_y() );
-
-        if( ( den_1 * num_2 != 0 ) ) {
-          sum += ( num_1 * den_2 ) / ( den_1 * num_2 );
-        } else { // Impossible to determine anisomorphism from this points.
-          den--;
-        }
-      }
-
-      tpi_iterator++;
-    }
+    // Pairs that cannot determine anisomorphism are not counted.
+    den -= invalid;
 
     anisomorphism_ = ( den )? ( sum / den ): 1.0;
 
     return true;
   }
 
-  bool evaluation_measurements::estimate_similarity(
-    const std::list<tie_point>& tie_points )
+  bool evaluation_measurements::compute_similarity(
+    const double* x, const double* y, const double* u, const double* v,
+    size_t n )
   {
-    std::list<tie_point> tp;
-
-    tp = tie_points;
-
-    if( tp.size() < 3 ) {
-      return false;
-    }
-
-    std::list<tie_point>::iterator tpi_iterator, tpj_iterator, tpk_iterator;
-
-    point x_y_i, u_v_i;
-    point x_y_j, u_v_j;
-    point x_y_k, u_v_k;
-
-    double den;
+    double den, sum;
 
     /* Estimates the similarity measurement */
     similarity_ = 0.0;
-    unsigned list_size = tp.size();
-    den =  math::binomial_number( list_size, 3 );
-    tpi_iterator = tp.begin();
-    for( unsigned i = 0; i < list_size - 2; i++ ) {
-      ( *tpi_iterator ).get( x_y_i, u_v_i );
-
-      tpj_iterator = tpi_iterator;
-      for( unsigned j = ( i + 1 ); j < list_size - 1; j++ ) {
-
-        tpj_iterator++;
-        ( *tpj_iterator ).get( x_y_j, u_v_j );
+    den =  math::binomial_number( n, 3 );
 
-        tpk_iterator = tpj_iterator;
-        for( unsigned k = ( j + 1 ); k < list_size; k++ ) {
-
-          tpk_iterator++;
-          ( *tpk_iterator ).get( x_y_k, u_v_k );
-
-          precision::vector v_xy_ij( x_y_i, x_y_j );
-          precision::vector v_xy_ik( x_y_i, x_y_k );
-
-          precision::vector v_uv_ij( u_v_i, u_v_j );
-          precision::vector v_uv_ik( u_v_i, u_v_k );
-
-          similarity_ += ( v_xy_ij.angle_b_vectors( v_xy_ik ) /
-                           v_uv_ij.angle_b_vectors( v_uv_ik )
-                         ) / den;
-        }
-      }
-      tpi_iterator++;
+    if( !simd_kernels::triplet_angle_ratio( x, y, u, v, n, sum ) ) {
+      return false;
     }
 
+    similarity_ = sum / den;
+
     return true;
   }
 
@@ -2,9 +2,13 @@
 #ifndef PRECISION_EVALUATION_MEASUREMENTS_HXX
 #define PRECISION_EVALUATION_MEASUREMENTS_HXX
 
+#include <precision/monotonic_arena.hxx>
 #include <precision/tie_point.hxx>
 
+#include <algorithm>
+#include <cstddef>
 #include <list>
+#include <vector>
 
 namespace precision {
   /**
@@ -30,6 +34,19 @@ namespace precision {
      */
     bool estimate_length_var( const std::list<tie_point>& tie_points );
 
+    /**
+     * Estimates the length variation of image from the given tie points,
+     * taking every temporary from @p arena.
+     *
+     * @param tie_points User Tie Points List
+     * @param arena Arena for temporaries, the caller releases it
+     * @return true if sucess, false on error
+     */
+    template<class _PCS_ALLOC>
+    bool estimate_length_var
+      ( const std::list<tie_point, _PCS_ALLOC>& tie_points,
+        monotonic_arena& arena );
+
     /**
      * Estimates the anisomorphism measurement of image from the given tie points
      *
@@ -39,13 +56,41 @@ namespace precision {
     bool estimate_anisomorphism( const std::list<tie_point>& tie_points );
 
     /**
-     * Estimates the similarity measurement of image from the given tie points
+     * Estimates the anisomorphism measurement of image from the given tie
+     * points, taking every temporary from @p arena.
      *
      * @param tie_points User Tie Points List
+     * @param arena Arena for temporaries, the caller releases it
      * @return true if sucess, false on error
      */
+    template<class _PCS_ALLOC>
+    bool estimate_anisomorphism
+      ( const std::list<tie_point, _PCS_ALLOC>& tie_points,
+        monotonic_arena& arena );
+
+    /**
+     * Estimates the similarity measurement of image from the given tie points
+     *
+     * @param tie_points User Tie Points List
+     * @return true if sucess, false on error or if two work or reference
+     *         points are equal
+     */
     bool estimate_similarity( const std::list<tie_point>& tie_points );
 
+    /**
+     * Estimates the similarity measurement of image from the given tie
+     * points, taking every temporary from @p arena.
+     *
+     * @param tie_points User Tie Points List
+     * @param arena Arena for temporaries, the caller releases it
+     * @return true if sucess, false on error or if two work or reference
+     *         points are equal
+     */
+    template<class _PCS_ALLOC>
+    bool estimate_similarity
+      ( const std::list<tie_point, _PCS_ALLOC>& tie_points,
+        monotonic_arena& arena );
+
     /**
      * Returns the length variation measurement.
      *
@@ -68,6 +113,37 @@ namespace precision {
     double get_similarity() const;
 
   private:
+    /**
+     * Estimates the length variation measurement from sorted and unique
+     * tie point coordinates.
+     *
+     * @param x Work coordinates in x axis.
+     * @param y Work coordinates in y axis.
+     * @param u Reference coordinates in x axis.
+     * @param v Reference coordinates in y axis.
+     * @param n Number of tie points, at least 2.
+     * @return true if sucess, false on error
+     */
+    bool compute_length_var( const double* x, const double* y,
+                             const double* u, const double* v, size_t n );
+
+    /**
+     * Estimates the anisomorphism measurement from tie point coordinates.
+     *
+     * @see compute_length_var
+     */
+    bool compute_anisomorphism( const double* x, const double* y,
+                                const double* u, const double* v, size_t n );
+
+    /**
+     * Estimates the similarity measurement from tie point coordinates.
+     *
+     * @param n Number of tie points, at least 3.
+     * @see compute_length_var
+     */
+    bool compute_similarity( const double* x, const double* y,
+                             const double* u, const double* v, size_t n );
+
     /**
      * Length variation measurement of image
      */
@@ -83,6 +159,108 @@ namespace precision {
      */
     double similarity_;
   };
+
+  namespace detail {
+    /**
+     * Copies tie points sorted and unique, as a std::set would give, to
+     * @p tp.
+     *
+     * @param first First tie point.
+     * @param last Tie point after the last.
+     * @param tp Sorted and unique tie points, replaced.
+     */
+    template<class _PCS_ITERATOR, class _PCS_ALLOC>
+    void unique_tie_points( _PCS_ITERATOR first, _PCS_ITERATOR last,
+                            std::vector<tie_point, _PCS_ALLOC>& tp )
+    {
+      tp.assign( first, last );
+      std::sort( tp.begin(), tp.end() );
+      tp.erase( std::unique( tp.begin(), tp.end() ), tp.end() );
+    }
+
+    /**
+     * Splits tie points in work and reference coordinate arrays allocated
+     * from @p arena, as expected by precision::simd_kernels.
+     *
+     * @param first First tie point.
+     * @param n Number of tie points.
+     * @param arena Arena for the arrays.
+     * @param x Work coordinates in x axis.
+     * @param y Work coordinates in y axis.
+     * @param u Reference coordinates in x axis.
+     * @param v Reference coordinates in y axis.
+     */
+    template<class _PCS_ITERATOR>
+    void split_coordinates( _PCS_ITERATOR first, size_t n,
+                            monotonic_arena& arena,
+                            double*& x, double*& y, double*& u, double*& v )
+    {
+      x = static_cast<double*>( arena.allocate( n * sizeof( double ) ) );
+      y = static_cast<double*>( arena.allocate( n * sizeof( double ) ) );
+      u = static_cast<double*>( arena.allocate( n * sizeof( double ) ) );
+      v = static_cast<double*>( arena.allocate( n * sizeof( double ) ) );
+
+      for( size_t i = 0; i < n; ++i, ++first ) {
+        point x_y, u_v;
+        first->get( x_y, u_v );
+
+        x[i] = x_y.get_x();
+        y[i] = x_y.get_y();
+        u[i] = u_v.get_x();
+        v[i] = u_v.get_y();
+      }
+    }
+  }
+
+  template<class _PCS_ALLOC>
+  bool evaluation_measurements::estimate_length_var(
+    const std::list<tie_point, _PCS_ALLOC>& tie_points,
+    monotonic_arena& arena )
+  {
+    tie_point_arena_vector tp( ( arena_allocator<tie_point>( arena ) ) );
+    detail::unique_tie_points( tie_points.begin(), tie_points.end(), tp );
+
+    if( tp.size() < 2 ) {
+      return false;
+    }
+
+    double *x, *y, *u, *v;
+    detail::split_coordinates( tp.begin(), tp.size(), arena, x, y, u, v );
+
+    return compute_length_var( x, y, u, v, tp.size() );
+  }
+
+  template<class _PCS_ALLOC>
+  bool evaluation_measurements::estimate_anisomorphism(
+    const std::list<tie_point, _PCS_ALLOC>& tie_points,
+    monotonic_arena& arena )
+  {
+    if( tie_points.size() < 2 ) {
+      return false;
+    }
+
+    double *x, *y, *u, *v;
+    detail::split_coordinates( tie_points.begin(), tie_points.size(), arena,
+                               x, y, u, v );
+
+    return compute_anisomorphism( x, y, u, v, tie_points.size() );
+  }
+
+  template<class _PCS_ALLOC>
+  bool evaluation_measurements::estimate_similarity(
+    const std::list<tie_point, _PCS_ALLOC>& tie_points,
+    monotonic_arena& arena )
+  {
+    if( tie_points.size() < 3 ) {
+      return false;
+    }
+
+    double *x, *y, *u, *v;
+    detail::split_coordinates( tie_points.begin(), tie_points.size(), arena,
+                               x, y, u, v );
+
+    return compute_similarity( x, y, u, v, tie_points.size() );
+  }
 }
 
 #endif // PRECISION_EVALUATION_MEASUREMENTS_HXX
@@ -0,0 +1,230 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/fixed_interpolation.hxx>
+#include <precision/interpolation.hxx>
+#include <precision/simd_kernels.hxx>
+
+#include <cmath>
+#include <vector>
+
+namespace precision {
+  namespace {
+    double clamp_distance( double u )
+    {
+      if( !( u > 0.0 ) ) {
+        return 0.0;
+      }
+      return ( u < 1.0 ) ? u : 1.0;
+    }
+
+    int32_t to_fixed( double w )
+    {
+      return static_cast<int32_t>(
+        std::floor( w * fixed_weights::ONE + 0.5 ) );
+    }
+
+    /**
+     * Source position of a resampled pixel, clamped to the source, with
+     * pixel centers aligned.
+     *
+     * @return Distance from the source pixel @p index.
+     */
+    double source_position( size_t i, double scale, size_t size,
+                            size_t& index )
+    {
+      double c = ( i + 0.5 ) * scale - 0.5;
+      double last = static_cast<double>( size - 1 );
+
+      if( !( c > 0.0 ) ) {
+        c = 0.0;
+      } else if( c > last ) {
+        c = last;
+      }
+
+      double f = std::floor( c );
+      index = static_cast<size_t>( f );
+      return c - f;
+    }
+
+    /**
+     * Index @p offset pixels away from @p index, clamped to [0, size - 1].
+     */
+    size_t clamp_index( size_t index, ptrdiff_t offset, size_t size )
+    {
+      ptrdiff_t i = static_cast<ptrdiff_t>( index ) + offset;
+
+      if( i < 0 ) {
+        return 0;
+      }
+      return ( static_cast<size_t>( i ) < size ) ? i : size - 1;
+    }
+  }
+
+  const int fixed_weights::SHIFT;
+  const int32_t fixed_weights::ONE;
+
+  void fixed_weights::linear( double u, int32_t weights[2] )
+  {
+    weights[1] = to_fixed( clamp_distance( u ) );
+    weights[0] = ONE - weights[1];
+  }
+
+  void fixed_weights::cubic( double u, int32_t weights[4] )
+  {
+    double w[4];
+    cubic_weights( clamp_distance( u ), w );
+
+    weights[0] = to_fixed( w[0] );
+    weights[2] = to_fixed( w[2] );
+    weights[3] = to_fixed( w[3] );
+    weights[1] = ONE - weights[0] - weights[2] - weights[3];
+  }
+
+  template<class _PCS_PIXEL>
+  _PCS_PIXEL fixed_interpolation<_PCS_PIXEL>::linear( _PCS_PIXEL f0,
+                                                      _PCS_PIXEL f1,
+                                                      double u )
+  {
+    int32_t w[2];
+    fixed_weights::linear( u, w );
+
+    return saturate( fixed_weights::round( w[0] * f0 + w[1] * f1 ) );
+  }
+
+  template<class _PCS_PIXEL>
+  _PCS_PIXEL fixed_interpolation<_PCS_PIXEL>::cubic( double distance,
+                                                     _PCS_PIXEL pt1,
+                                                     _PCS_PIXEL pt2,
+                                                     _PCS_PIXEL pt3,
+                                                     _PCS_PIXEL pt4 )
+  {
+    int32_t w[4];
+    fixed_weights::cubic( distance, w );
+
+    return saturate( fixed_weights::round( w[0] * pt1 + w[1] * pt2 +
+                                           w[2] * pt3 + w[3] * pt4 ) );
+  }
+
+  template<class _PCS_PIXEL>
+  _PCS_PIXEL fixed_interpolation<_PCS_PIXEL>::bilinear( _PCS_PIXEL f00,
+                                                        _PCS_PIXEL f10,
+                                                        _PCS_PIXEL f01,
+                                                        _PCS_PIXEL f11,
+                                                        double u, double v )
+  {
+    int32_t wx[2], wy[2];
+    fixed_weights::linear( u, wx );
+    fixed_weights::linear( v, wy );
+
+    int32_t h0 = fixed_weights::round( wx[0] * f00 + wx[1] * f10 );
+    int32_t h1 = fixed_weights::round( wx[0] * f01 + wx[1] * f11 );
+
+    return saturate( fixed_weights::round( wy[0] * h0 + wy[1] * h1 ) );
+  }
+
+  template<class _PCS_PIXEL>
+  _PCS_PIXEL fixed_interpolation<_PCS_PIXEL>::bicubic( const _PCS_PIXEL f[16],
+                                                       double u, double v )
+  {
+    int32_t wx[4], wy[4];
+    fixed_weights::cubic( u, wx );
+    fixed_weights::cubic( v, wy );
+
+    int32_t sum = 0;
+    for( size_t j = 0; j < 4; j++ ) {
+      const _PCS_PIXEL* row = f + 4 * j;
+      int32_t h = fixed_weights::round( wx[0] * row[0] + wx[1] * row[1] +
+                                        wx[2] * row[2] + wx[3] * row[3] );
+      sum += wy[j] * h;
+    }
+
+    return saturate( fixed_weights::round( sum ) );
+  }
+
+  template<class _PCS_PIXEL>
+  bool fixed_interpolation<_PCS_PIXEL>::resample( const _PCS_PIXEL* src,
+                                                  size_t src_width,
+                                                  size_t src_height,
+                                                  _PCS_PIXEL* dst,
+                                                  size_t dst_width,
+                                                  size_t dst_height,
+                                                  mode m )
+  {
+    if( !src_width || !src_height || !dst_width || !dst_height ) {
+      return false;
+    }
+
+    // Taps before the pixel at the position.
+    const ptrdiff_t before = ( m == BICUBIC ) ? 1 : 0;
+    const size_t taps = ( m == BICUBIC ) ? 4 : 2;
+    int32_t w[4];
+
+    /* Weights and first padded pixel of every resampled column */
+    std::vector<int32_t> index( dst_width );
+    std::vector<int32_t> weights( taps * dst_width );
+    double scale = static_cast<double>( src_width ) / dst_width;
+
+    for( size_t i = 0; i < dst_width; i++ ) {
+      size_t ix;
+      double u = source_position( i, scale, src_width, ix );
+
+      if( m == BICUBIC ) {
+        fixed_weights::cubic( u, w );
+      } else {
+        fixed_weights::linear( u, w );
+      }
+
+      for( size_t k = 0; k < taps; k++ ) {
+        weights[k * dst_width + i] = w[k];
+      }
+      index[i] = static_cast<int32_t>( ix + 1 - before );
+    }
+
+    /* Row pass, on rows padded with one replicated pixel on the left and
+       two on the right */
+    std::vector<int32_t> padded( src_width + 3 );
+    std::vector<int32_t> rows( src_height * dst_width );
+
+    for( size_t j = 0; j < src_height; j++ ) {
+      const _PCS_PIXEL* row = src + j * src_width;
+
+      for( size_t p = 0; p < padded.size(); p++ ) {
+        padded[p] = row[clamp_index( p, -1, src_width )];
+      }
+
+      simd_kernels::fixed_rows( &padded[0], &index[0], &weights[0], taps,
+                                &rows[j * dst_width], dst_width );
+    }
+
+    /* Column pass, whole rows at a time */
+    scale = static_cast<double>( src_height ) / dst_height;
+
+    for( size_t j = 0; j < dst_height; j++ ) {
+      size_t iy;
+      double v = source_position( j, scale, src_height, iy );
+      const int32_t* in[4];
+
+      if( m == BICUBIC ) {
+        fixed_weights::cubic( v, w );
+      } else {
+        fixed_weights::linear( v, w );
+      }
+
+      for( size_t k = 0; k < taps; k++ ) {
+        in[k] = &rows[clamp_index( iy, static_cast<ptrdiff_t>( k ) - before,
+                                      src_height ) * dst_width];
+      }
+
+      simd_kernels::fixed_columns( in, w, taps, dst + j * dst_width,
+                                   dst_width );
+    }
+
+    return true;
+  }
+
+  template class fixed_interpolation<uint8_t>;
+  template class fixed_interpolation<uint16_t>;
+}
@@ -0,0 +1,178 @@
+#ifndef PRECISION_FIXED_INTERPOLATION_HXX
+#define PRECISION_FIXED_INTERPOLATION_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace precision {
+  /**
+   * Q14 fixed-point interpolation weights.
+   *
+   * Distances are clamped to [0,1]. The linear weights of distance u are
+   * ( 2^14 - w, w ) with w = floor( u * 2^14 + 0.5 ). The cubic weights are
+   * the ones of precision::cubic_weights() scaled by 2^14 and rounded the
+   * same way, except the second one, which is 2^14 minus the others so the
+   * weights always add up to exactly 2^14.
+   *
+   * All methods are static.
+   * To prevent instantiation, constructor is private.
+   */
+  class fixed_weights {
+  public:
+    /// Number of fractional bits.
+    static const int SHIFT = 14;
+
+    /// Weight of 1.0.
+    static const int32_t ONE = 1 << SHIFT;
+
+    /**
+     * Computes the linear weights of a distance.
+     *
+     * @param u Distance from the first point.
+     * @param weights Weights of the two points.
+     */
+    static void linear( double u, int32_t weights[2] );
+
+    /**
+     * Computes the cubic convolution weights of a distance.
+     *
+     * @param u Distance from the second point.
+     * @param weights Weights of the four points.
+     */
+    static void cubic( double u, int32_t weights[4] );
+
+    /**
+     * Rounds a weighted sum to an integer, ( sum + 2^13 ) >> 14, with an
+     * arithmetic shift, so halves round up.
+     *
+     * @param sum Sum of Q14 weights times integer values.
+     * @return Rounded value.
+     */
+    static inline int32_t round( int32_t sum ) {
+      return ( sum + ( ONE >> 1 ) ) >> SHIFT;
+    }
+
+  private:
+    /// Undefined constructor.
+    fixed_weights();
+  };
+
+  /**
+   * Interpolation of 8 and 16 bit unsigned pixels with fixed_weights.
+   *
+   * Integer counterpart of precision::cubic(), precision::bilinear() and
+   * precision::bicubic(), without conversion to double. Sums are computed
+   * exactly in 32 bit integers, where they fit even for 16 bit bicubic,
+   * and rounded with fixed_weights::round().
+   * Two dimensional interpolations round the row pass, keep it unsaturated,
+   * and then round the column pass. Results are saturated to the pixel
+   * range, so they are bit-exact for a given pixel type and distances on any
+   * CPU.
+   *
+   * Only uint8_t and uint16_t pixels are available.
+   *
+   * All methods are static.
+   * To prevent instantiation, constructor is private.
+   */
+  template<class _PCS_PIXEL>
+  class fixed_interpolation {
+  public:
+    /**
+     * Resampling mode
+     */
+    enum mode {
+      BILINEAR = 0,
+      BICUBIC
+    };
+
+    /**
+     * Perform a linear interpolation.
+     *
+     * @param f0 Value of the first point.
+     * @param f1 Value of the second point.
+     * @param u Distance from the first point, in [0,1].
+     * @return Interpolated value.
+     */
+    static _PCS_PIXEL linear( _PCS_PIXEL f0, _PCS_PIXEL f1, double u );
+
+    /**
+     * Perform a cubic interpolation.
+     *
+     * @param distance Distance from the second point, in [0,1].
+     * @param pt1 Value of the first point.
+     * @param pt2 Value of the second point.
+     * @param pt3 Value of the third point.
+     * @param pt4 Value of the fourth point.
+     * @return Interpolated value.
+     */
+    static _PCS_PIXEL cubic( double distance, _PCS_PIXEL pt1, _PCS_PIXEL pt2,
+                             _PCS_PIXEL pt3, _PCS_PIXEL pt4 );
+
+    /**
+     * Perform a bilinear interpolation.
+     *
+     * @param f00 Value at (0,0).
+     * @param f10 Value at (1,0).
+     * @param f01 Value at (0,1).
+     * @param f11 Value at (1,1).
+     * @param u x-coordinate of the desired point, in [0,1].
+     * @param v y-coordinate of the desired point, in [0,1].
+     * @return Interpolated value.
+     */
+    static _PCS_PIXEL bilinear( _PCS_PIXEL f00, _PCS_PIXEL f10,
+                                _PCS_PIXEL f01, _PCS_PIXEL f11,
+                                double u, double v );
+
+    /**
+     * Perform a bicubic interpolation.
+     *
+     * @param f 4x4 values, row by row, f[5] is the value at (0,0).
+     * @param u x-coordinate of the desired point, in [0,1].
+     * @param v y-coordinate of the desired point, in [0,1].
+     * @return Interpolated value.
+     */
+    static _PCS_PIXEL bicubic( const _PCS_PIXEL f[16], double u, double v );
+
+    /**
+     * Resamples an image to another size, with the rows and columns of many
+     * pixels at a time on precision::simd_kernels. Pixel centers are
+     * aligned, border pixels are replicated, and every pixel is the one
+     * bilinear() or bicubic() gives for its neighbourhood.
+     *
+     * @param src Source image, row-major.
+     * @param src_width Source width.
+     * @param src_height Source height.
+     * @param dst Resampled image, dst_width * dst_height pixels.
+     * @param dst_width Resampled width.
+     * @param dst_height Resampled height.
+     * @param m Resampling mode.
+     * @return true if sucess, false if a size is 0
+     */
+    static bool resample( const _PCS_PIXEL* src,
+                          size_t src_width, size_t src_height,
+                          _PCS_PIXEL* dst, size_t dst_width, size_t dst_height,
+                          mode m = BILINEAR );
+
+  private:
+    /**
+     * Saturates a value to the pixel range.
+     *
+     * @param value Value.
+     * @return Saturated value.
+     */
+    static inline _PCS_PIXEL saturate( int32_t value ) {
+      const int32_t max = std::numeric_limits<_PCS_PIXEL>::max();
+      return static_cast<_PCS_PIXEL>( value < 0 ? 0 :
+                                      ( value > max ? max : value ) );
+    }
+
+    /// Undefined constructor.
+    fixed_interpolation();
+  };
+
+  extern template class fixed_interpolation<uint8_t>;
+  extern template class fixed_interpolation<uint16_t>;
+}
+
+#endif // PRECISION_FIXED_INTERPOLATION_HXX
@@ -201,6 +201,20 @@ namespace precision {
     return p0 + p1 + p2 + p3;
   }
 
+  /**
+   * Computes the cubic convolution weights used by cubic().
+   *
+   * @param u relative distance from the second point, in [0,1].
+   * @param weights weights of the four points.
+   */
+  inline void cubic_weights( double u, double weights[4] )
+  {
+    weights[0] = -u * (1.0 - u) * (1.0 - u);
+    weights[1] = (1.0 - u) * (1.0 + u - u * u);
+    weights[2] = u * (1.0 + u - u * u);
+    weights[3] = - u * u * (1.0 - u);
+  }
+
   /**
    * Perform a cubic interpolation.
    * The points must follow an ascending order, i. e., pt1 < pt2 < pt3 < pt4.
@@ -226,12 +240,7 @@ namespace precision {
 
     if( !initialized ) {
       for( size_t i = 0 ; i < 101; ++i ) {
-        double u( 0.01 * i );
-
-        weights_[i][0] = -u * (1.0 - u) * (1.0 - u);
-        weights_[i][1] = (1.0 - u) * (1.0 + u - u * u);
-        weights_[i][2] = u * (1.0 + u - u * u);
-        weights_[i][3] = - u * u * (1.0 - u);
+        cubic_weights( 0.01 * i, weights_[i] );
       }
       initialized = true;
     }
@@ -0,0 +1,218 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/lookup_table.hxx>
+#include <precision/simd_kernels.hxx>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace precision {
+  namespace {
+    /// Relative tolerance for samples to be considered uniformly spaced.
+    const double UNIFORM_TOLERANCE = 1e-9;
+
+    /// Largest number of buckets per segment in the index of non-uniform
+    /// samples.
+    const size_t MAX_BUCKETS_PER_SEGMENT = 64;
+
+    /// Largest number of buckets in the index of tables with fewer
+    /// segments.
+    const size_t MAX_BUCKETS = 1 << 16;
+  }
+
+  lookup_table::lookup_table( const std::vector<double>& x,
+                              const std::vector<double>& f, mode m )
+      :x_( x ), f_( f ), mode_( m ), uniform_( false ), x0_( x[0] ),
+       step_( 0.0 ), bucket_scale_( 0.0 )
+  {
+    assert( x.size() >= 2 );
+    assert( x.size() == f.size() );
+
+    build_index();
+  }
+
+  lookup_table::lookup_table( double x0, double step,
+                              const std::vector<double>& f, mode m )
+      :f_( f ), mode_( m ), uniform_( true ), x0_( x0 ), step_( step ),
+       bucket_scale_( 0.0 )
+  {
+    assert( f.size() >= 2 );
+    assert( step > 0 );
+  }
+
+  lookup_table::~lookup_table()
+  {
+  }
+
+  double lookup_table::at( double x ) const
+  {
+    double u;
+    size_t k = find_segment( x, u );
+
+    return interpolate( k, u );
+  }
+
+  void lookup_table::apply( const double* in, double* out, size_t n ) const
+  {
+    if( uniform_ ) {
+      if( mode_ == CUBIC ) {
+        simd_kernels::lookup_cubic( &f_[0], f_.size(), x0_, step_,
+                                    in, out, n );
+      } else {
+        simd_kernels::lookup_linear( &f_[0], f_.size(), x0_, step_,
+                                     in, out, n );
+      }
+      return;
+    }
+
+    for( size_t i = 0; i < n; i++ ) {
+      out[i] = at( in[i] );
+    }
+  }
+
+  void lookup_table::apply( std::vector<double>& values ) const
+  {
+    if( !values.empty() ) {
+      apply( &values[0], &values[0], values.size() );
+    }
+  }
+
+  bool lookup_table::is_uniform() const
+  {
+    return uniform_;
+  }
+
+  lookup_table::mode lookup_table::get_mode() const
+  {
+    return mode_;
+  }
+
+  void lookup_table::build_index()
+  {
+    const size_t segments = x_.size() - 1;
+    const double range = x_.back() - x_.front();
+    const double step = range / segments;
+
+    uniform_ = true;
+    for( size_t i = 0; i < x_.size() && uniform_; i++ ) {
+      assert( i == 0 || x_[i] > x_[i - 1] );
+      uniform_ = std::fabs( x_[i] - ( x0_ + i * step ) ) <=
+                 UNIFORM_TOLERANCE * step;
+    }
+
+    if( uniform_ ) {
+      step_ = step;
+      x_.clear();
+      return;
+    }
+
+    double min_width = range;
+    inv_width_.resize( segments );
+    for( size_t i = 0; i < segments; i++ ) {
+      min_width = std::min( min_width, x_[i + 1] - x_[i] );
+      inv_width_[i] = 1.0 / ( x_[i + 1] - x_[i] );
+    }
+
+    // Bucket b covers [x0 + b / scale, x0 + (b + 1) / scale) and stores the
+    // segment holding its start. Buckets no wider than the narrowest
+    // segment hold at most two segments; past the cap, wide spreads of
+    // widths (geometric nodes) leave more segments to search in a bucket.
+    const double wanted = std::ceil( range / min_width );
+    const size_t cap = std::min( segments * MAX_BUCKETS_PER_SEGMENT,
+                                 std::max( segments, MAX_BUCKETS ) );
+
+    buckets_.resize( ( wanted < cap ) ? static_cast<size_t>( wanted ) : cap );
+    bucket_scale_ = buckets_.size() / range;
+
+    size_t k = 0;
+    for( size_t b = 0; b < buckets_.size(); b++ ) {
+      double start = x0_ + b / bucket_scale_;
+      while( k + 1 < segments && x_[k + 1] <= start ) {
+        k++;
+      }
+      buckets_[b] = k;
+    }
+  }
+
+  size_t lookup_table::find_segment( double x, double& u ) const
+  {
+    const size_t last = f_.size() - 2;
+
+    if( uniform_ ) {
+      // Same rounding as simd_kernels::lookup_linear/lookup_cubic.
+      double t = ( x - x0_ ) * ( 1.0 / step_ );
+      t = ( t > 0.0 ) ? t : 0.0;
+      t = ( t < last + 1.0 ) ? t : last + 1.0;
+
+      size_t k = static_cast<size_t>( t );
+      k = ( k < last ) ? k : last;
+      u = t - k;
+      return k;
+    }
+
+    if( !( x > x_.front() ) ) {
+      u = 0.0;
+      return 0;
+    }
+    if( x >= x_.back() ) {
+      u = 1.0;
+      return last;
+    }
+
+    size_t b = static_cast<size_t>( ( x - x0_ ) * bucket_scale_ );
+    b = ( b < buckets_.size() ) ? b : buckets_.size() - 1;
+
+    // Binary search of the nodes in the bucket, one or two unless the
+    // bucket count was capped.
+    size_t first = buckets_[b];
+    size_t end = ( b + 1 < buckets_.size() ) ? buckets_[b + 1] + 1 : last + 1;
+    size_t k = std::upper_bound( x_.begin() + first + 1, x_.begin() + end, x ) -
+               x_.begin() - 1;
+
+    // Rounding of the bucket position may land one segment off.
+    while( k > 0 && x_[k] > x ) {
+      k--;
+    }
+    while( k < last && x_[k + 1] <= x ) {
+      k++;
+    }
+
+    u = ( x - x_[k] ) * inv_width_[k];
+    return k;
+  }
+
+  double lookup_table::interpolate( size_t k, double u ) const
+  {
+    if( mode_ == LINEAR ) {
+      return f_[k] + u * ( f_[k + 1] - f_[k] );
+    }
+
+    // Slopes at the segment nodes, in units of the segment width, from
+    // central differences, one-sided at the border nodes.
+    size_t k0 = ( k > 0 ) ? k - 1 : 0;
+    size_t k3 = ( k + 2 < f_.size() ) ? k + 2 : f_.size() - 1;
+    double d1, d2;
+
+    if( uniform_ ) {
+      // Same as simd_kernels::lookup_cubic.
+      d1 = ( f_[k + 1] - f_[k0] ) / static_cast<double>( k + 1 - k0 );
+      d2 = ( f_[k3] - f_[k] ) / static_cast<double>( k3 - k );
+    } else {
+      double width = x_[k + 1] - x_[k];
+      d1 = ( f_[k + 1] - f_[k0] ) / ( x_[k + 1] - x_[k0] ) * width;
+      d2 = ( f_[k3] - f_[k] ) / ( x_[k3] - x_[k] ) * width;
+    }
+
+    double u2 = u * u;
+    double u3 = u2 * u;
+
+    return f_[k] * ( 2.0 * u3 - 3.0 * u2 + 1.0 ) +
+           d1 * ( u3 - 2.0 * u2 + u ) +
+           f_[k + 1] * ( 3.0 * u2 - 2.0 * u3 ) +
+           d2 * ( u3 - u2 );
+  }
+}
@@ -0,0 +1,143 @@
+#ifndef PRECISION_LOOKUP_TABLE_HXX
+#define PRECISION_LOOKUP_TABLE_HXX
+
+#include <cstddef>
+#include <vector>
+
+namespace precision {
+  /**
+   * One dimensional lookup table interpolator.
+   *
+   * Built from samples (x, f(x)) with strictly increasing x, it finds the
+   * bracketing nodes of a value without a binary search over the table: by
+   * direct indexing when the samples are uniformly spaced, and through a
+   * precomputed bucket index otherwise. Buckets are as narrow as the
+   * narrowest segment, up to 64 per segment and 65536 in total (or one per
+   * segment in larger tables); when that cap leaves several segments in a
+   * bucket, only those are binary searched.
+   *
+   * LINEAR mode gives the result of precision::linear() on the bracketing
+   * nodes. CUBIC mode is a cubic Hermite spline whose slope at a node is the
+   * finite difference between its neighbours, taken on the real node
+   * spacing, and one-sided at the border nodes: Catmull-Rom on uniform
+   * nodes. Both modes reproduce linear functions exactly on any spacing.
+   * Values outside the table are clamped to its range.
+   */
+  class lookup_table {
+  public:
+    /**
+     * Interpolation mode
+     */
+    enum mode {
+      LINEAR = 0,
+      CUBIC
+    };
+
+    /**
+     * Constructor from arbitrary samples. Uniformly spaced samples are
+     * detected and use direct indexing.
+     *
+     * @param x Domain of the samples, strictly increasing, at least 2.
+     * @param f Image of the samples, same size of @p x.
+     * @param m Interpolation mode.
+     */
+    lookup_table( const std::vector<double>& x, const std::vector<double>& f,
+                  mode m = LINEAR );
+
+    /**
+     * Constructor from uniformly spaced samples.
+     *
+     * @param x0 Domain coordinate of the first sample.
+     * @param step Distance between samples, greater than 0.
+     * @param f Image of the samples, at least 2.
+     * @param m Interpolation mode.
+     */
+    lookup_table( double x0, double step, const std::vector<double>& f,
+                  mode m = LINEAR );
+
+    /**
+     * Default destructor.
+     */
+    ~lookup_table();
+
+    /**
+     * Interpolates one value.
+     *
+     * @param x Domain coordinate.
+     * @return Interpolated value.
+     */
+    double at( double x ) const;
+
+    /**
+     * Interpolates an array of values. Uniform tables run on
+     * precision::simd_kernels, non-uniform ones look up one value at a
+     * time.
+     *
+     * @param in Domain coordinates.
+     * @param out Interpolated values, may be equal to @p in.
+     * @param n Number of values.
+     */
+    void apply( const double* in, double* out, size_t n ) const;
+
+    /**
+     * Interpolates a vector of values in place.
+     *
+     * @param values Domain coordinates, replaced by the interpolated values.
+     */
+    void apply( std::vector<double>& values ) const;
+
+    /**
+     * Returns if the samples are uniformly spaced.
+     *
+     * @return uniform_
+     */
+    bool is_uniform() const;
+
+    /**
+     * Returns the interpolation mode.
+     *
+     * @return mode_
+     */
+    mode get_mode() const;
+
+  private:
+    /**
+     * Builds the bucket index of non-uniform samples, or switches to direct
+     * indexing if the samples are uniform.
+     */
+    void build_index();
+
+    /**
+     * Finds the bracketing segment of a value and its relative distance
+     * in the segment.
+     *
+     * @param x Domain coordinate.
+     * @param u Relative distance in the segment, in [0,1].
+     * @return Index of the first node of the segment.
+     */
+    size_t find_segment( double x, double& u ) const;
+
+    /**
+     * Interpolates in a segment.
+     *
+     * @param k Index of the first node of the segment.
+     * @param u Relative distance in the segment.
+     * @return Interpolated value.
+     */
+    double interpolate( size_t k, double u ) const;
+
+    std::vector<double> x_; ///< Domain of the samples, empty if uniform.
+    std::vector<double> f_; ///< Image of the samples.
+    mode mode_; ///< Interpolation mode.
+
+    bool uniform_; ///< If samples are uniformly spaced.
+    double x0_; ///< Domain coordinate of the first sample.
+    double step_; ///< Distance between samples, if uniform.
+
+    std::vector<double> inv_width_; ///< Inverse of each segment width.
+    std::vector<size_t> buckets_; ///< First segment of each bucket.
+    double bucket_scale_; ///< Buckets per domain unit.
+  };
+}
+
+#endif // PRECISION_LOOKUP_TABLE_HXX
@@ -78,7 +78,15 @@ namespace precision {
     assert( k > 0 );
     assert( n >= k );
 
-    return long ( factorial( n ) / ( factorial( k ) * factorial( n - k ) ) );
+    // Multiplicative form, every partial product is a binomial number
+    // itself, so it stays exact where the factorial quotient is truncated.
+    long result = 1;
+
+    for( int i = 1; i <= k; i++ ) {
+      result = result * ( n - k + i ) / i;
+    }
+
+    return result;
   }
 
   double math::compute_squared_distance( const double& x1,
@@ -0,0 +1,104 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/monotonic_arena.hxx>
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace precision {
+
+  monotonic_arena::monotonic_arena( size_t block_size )
+      :offset_( 0 ), used_( 0 ), block_size_( block_size ? block_size : 1 ),
+       system_allocations_( 0 )
+  {
+  }
+
+  monotonic_arena::~monotonic_arena()
+  {
+    for( size_t i = 0; i < blocks_.size(); i++ ) {
+      ::operator delete( blocks_[i].data );
+    }
+  }
+
+  void* monotonic_arena::allocate( size_t bytes, size_t alignment )
+  {
+    assert( alignment && ( alignment & ( alignment - 1 ) ) == 0 );
+
+    if( !blocks_.empty() ) {
+      block& current = blocks_.back();
+      uintptr_t address = reinterpret_cast<uintptr_t>( current.data ) + offset_;
+      size_t padding = ( alignment - address % alignment ) % alignment;
+
+      if( offset_ + padding + bytes <= current.size ) {
+        offset_ += padding + bytes;
+        return current.data + offset_ - bytes;
+      }
+    }
+
+    // Operator new memory is aligned for any fundamental type, larger
+    // alignments may need padding in the new block.
+    add_block( bytes + alignment );
+    return allocate( bytes, alignment );
+  }
+
+  void monotonic_arena::release()
+  {
+    if( blocks_.size() > 1 ) {
+      // Merges all blocks in one, so the next round of allocations of the
+      // same size does not ask the system for memory.
+      size_t capacity = get_capacity();
+
+      for( size_t i = 0; i < blocks_.size(); i++ ) {
+        ::operator delete( blocks_[i].data );
+      }
+      blocks_.clear();
+
+      block_size_ = capacity;
+      add_block( capacity );
+    }
+
+    offset_ = 0;
+    used_ = 0;
+  }
+
+  size_t monotonic_arena::get_used() const
+  {
+    return used_ + offset_;
+  }
+
+  size_t monotonic_arena::get_capacity() const
+  {
+    size_t capacity = 0;
+
+    for( size_t i = 0; i < blocks_.size(); i++ ) {
+      capacity += blocks_[i].size;
+    }
+
+    return capacity;
+  }
+
+  size_t monotonic_arena::get_system_allocations() const
+  {
+    return system_allocations_;
+  }
+
+  void monotonic_arena::add_block( size_t min_size )
+  {
+    block b;
+    b.size = ( min_size > block_size_ ) ? min_size : block_size_;
+    b.data = static_cast<char*>( ::operator new( b.size ) );
+
+    used_ += offset_;
+    offset_ = 0;
+
+    blocks_.push_back( b );
+    system_allocations_++;
+
+    // Geometric growth keeps the number of blocks logarithmic.
+    block_size_ = b.size * 2;
+  }
+}
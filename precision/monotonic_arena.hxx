@@ -0,0 +1,174 @@
+#ifndef PRECISION_MONOTONIC_ARENA_HXX
+#define PRECISION_MONOTONIC_ARENA_HXX
+
+#include <cstddef>
+#include <vector>
+
+namespace precision {
+  /**
+   * Monotonic memory arena.
+   *
+   * Memory is handed out sequentially from large blocks and is only given
+   * back all at once, by release(). After a release the blocks are kept (and
+   * merged into one), so a caller that resets the arena between image pairs
+   * of similar size stops allocating after the first pair.
+   *
+   * An arena is not thread-safe, use one per thread.
+   */
+  class monotonic_arena {
+  public:
+    /**
+     * Default constructor.
+     *
+     * @param block_size Size in bytes of the first block. It is allocated
+     *                   on the first request.
+     */
+    explicit monotonic_arena( size_t block_size = 65536 );
+
+    /**
+     * Destructor. Frees every block.
+     */
+    ~monotonic_arena();
+
+    /**
+     * Allocates memory from the arena.
+     *
+     * @param bytes Number of bytes.
+     * @param alignment Alignment, must be a power of two.
+     * @return Pointer to the allocated memory.
+     */
+    void* allocate( size_t bytes, size_t alignment = alignof( double ) );
+
+    /**
+     * Gives back all memory allocated from the arena. Pointers returned by
+     * allocate() are invalid after this call.
+     */
+    void release();
+
+    /**
+     * Returns the number of bytes allocated since the last release.
+     *
+     * @return Allocated bytes, including alignment padding.
+     */
+    size_t get_used() const;
+
+    /**
+     * Returns the number of bytes held by the arena.
+     *
+     * @return Sum of the block sizes.
+     */
+    size_t get_capacity() const;
+
+    /**
+     * Returns the number of blocks requested from the system since the
+     * arena was created.
+     *
+     * @return Number of system allocations.
+     */
+    size_t get_system_allocations() const;
+
+  private:
+    /// Undefined copy constructor.
+    monotonic_arena( const monotonic_arena& );
+
+    /// Undefined assignment operator.
+    monotonic_arena& operator = ( const monotonic_arena& );
+
+    /**
+     * Allocates a new block and makes it current.
+     *
+     * @param min_size Minimum block size in bytes.
+     */
+    void add_block( size_t min_size );
+
+    /**
+     * Memory block
+     */
+    struct block {
+      char* data; ///< Block memory
+      size_t size; ///< Block size in bytes
+    };
+
+    std::vector<block> blocks_; ///< Blocks, the last one is the current.
+    size_t offset_; ///< First free byte in the current block.
+    size_t used_; ///< Bytes used in the previous blocks.
+    size_t block_size_; ///< Size of the next block.
+    size_t system_allocations_; ///< Blocks requested from the system.
+  };
+
+  /**
+   * Standard allocator that takes its memory from a precision::monotonic_arena.
+   *
+   * deallocate() does nothing, memory is given back by
+   * monotonic_arena::release(). Containers using it must not outlive
+   * the arena or be used after the arena is released.
+   */
+  template<class _PCS_TYPE>
+  class arena_allocator {
+  public:
+    typedef _PCS_TYPE value_type;
+
+    /**
+     * Default constructor.
+     *
+     * @param arena Arena memory comes from.
+     */
+    explicit arena_allocator( monotonic_arena& arena ) : arena_( &arena ) {
+    }
+
+    /**
+     * Conversion from an allocator of another type, sharing its arena.
+     *
+     * @param other Other allocator.
+     */
+    template<class _PCS_OTHER>
+    arena_allocator( const arena_allocator<_PCS_OTHER>& other )
+        : arena_( &other.get_arena() ) {
+    }
+
+    /**
+     * Allocates memory for @p n objects.
+     *
+     * @param n Number of objects.
+     * @return Pointer to uninitialized memory.
+     */
+    _PCS_TYPE* allocate( size_t n ) {
+      return static_cast<_PCS_TYPE*>(
+        arena_->allocate( n * sizeof( _PCS_TYPE ), alignof( _PCS_TYPE ) ) );
+    }
+
+    /**
+     * Does nothing, see monotonic_arena::release().
+     */
+    void deallocate( _PCS_TYPE*, size_t ) {
+    }
+
+    /**
+     * Returns the arena memory comes from.
+     *
+     * @return Arena.
+     */
+    monotonic_arena& get_arena() const {
+      return *arena_;
+    }
+
+  private:
+    monotonic_arena* arena_; ///< Arena memory comes from.
+  };
+
+  template<class _PCS_LHS, class _PCS_RHS>
+  bool operator == ( const arena_allocator<_PCS_LHS>& lhs,
+                     const arena_allocator<_PCS_RHS>& rhs )
+  {
+    return &lhs.get_arena() == &rhs.get_arena();
+  }
+
+  template<class _PCS_LHS, class _PCS_RHS>
+  bool operator != ( const arena_allocator<_PCS_LHS>& lhs,
+                     const arena_allocator<_PCS_RHS>& rhs )
+  {
+    return !( lhs == rhs );
+  }
+}
+
+#endif // PRECISION_MONOTONIC_ARENA_HXX
@@ -0,0 +1,126 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/simd_kernels.hxx>
+#include <precision/simd_kernels_impl.hxx>
+
+namespace precision {
+
+  void simd_kernels::squared_distances( const double* x1, const double* y1,
+                                        const double* x2, const double* y2,
+                                        double* out, size_t n )
+  {
+    detail::active_kernels().squared_distances( x1, y1, x2, y2, out, n );
+  }
+
+  void simd_kernels::distances( const double* x1, const double* y1,
+                                const double* x2, const double* y2,
+                                double* out, size_t n )
+  {
+    detail::active_kernels().distances( x1, y1, x2, y2, out, n );
+  }
+
+  void simd_kernels::linear( const double* f0, const double* f1,
+                             const double* t, double* out, size_t n )
+  {
+    detail::active_kernels().linear( f0, f1, t, out, n );
+  }
+
+  void simd_kernels::normalize( const double* in, double offset, double scale,
+                                double* out, size_t n )
+  {
+    detail::active_kernels().normalize( in, offset, scale, out, n );
+  }
+
+  bool simd_kernels::pairwise_length_ratio( const double* x, const double* y,
+                                            const double* u, const double* v,
+                                            size_t n, double& sum )
+  {
+    return pairwise_length_ratio( x, y, u, v, n, 0, n, sum );
+  }
+
+  bool simd_kernels::pairwise_length_ratio( const double* x, const double* y,
+                                            const double* u, const double* v,
+                                            size_t n, size_t i_begin,
+                                            size_t i_end, double& sum )
+  {
+    return detail::active_kernels().pairwise_length_ratio( x, y, u, v, n,
+                                                           i_begin, i_end,
+                                                           sum );
+  }
+
+  void simd_kernels::pairwise_anisomorphism( const double* x, const double* y,
+                                             const double* u, const double* v,
+                                             size_t n, double& sum,
+                                             size_t& invalid )
+  {
+    pairwise_anisomorphism( x, y, u, v, n, 0, n, sum, invalid );
+  }
+
+  void simd_kernels::pairwise_anisomorphism( const double* x, const double* y,
+                                             const double* u, const double* v,
+                                             size_t n, size_t i_begin,
+                                             size_t i_end, double& sum,
+                                             size_t& invalid )
+  {
+    detail::active_kernels().pairwise_anisomorphism( x, y, u, v, n,
+                                                     i_begin, i_end,
+                                                     sum, invalid );
+  }
+
+  bool simd_kernels::triplet_angle_ratio( const double* x, const double* y,
+                                          const double* u, const double* v,
+                                          size_t n, double& sum )
+  {
+    return triplet_angle_ratio( x, y, u, v, n, 0, n, sum );
+  }
+
+  bool simd_kernels::triplet_angle_ratio( const double* x, const double* y,
+                                          const double* u, const double* v,
+                                          size_t n, size_t i_begin,
+                                          size_t i_end, double& sum )
+  {
+    return detail::active_kernels().triplet_angle_ratio( x, y, u, v, n,
+                                                         i_begin, i_end,
+                                                         sum );
+  }
+
+  void simd_kernels::lookup_linear( const double* f, size_t m, double x0,
+                                    double step, const double* in,
+                                    double* out, size_t n )
+  {
+    detail::active_kernels().lookup_linear( f, m, x0, 1.0 / step,
+                                            in, out, n );
+  }
+
+  void simd_kernels::lookup_cubic( const double* f, size_t m, double x0,
+                                   double step, const double* in,
+                                   double* out, size_t n )
+  {
+    detail::active_kernels().lookup_cubic( f, m, x0, 1.0 / step,
+                                           in, out, n );
+  }
+
+  void simd_kernels::fixed_rows( const int32_t* in, const int32_t* index,
+                                 const int32_t* weights, size_t taps,
+                                 int32_t* out, size_t n )
+  {
+    detail::active_kernels().fixed_rows( in, index, weights, taps, out, n );
+  }
+
+  void simd_kernels::fixed_columns( const int32_t* const* rows,
+                                    const int32_t* weights, size_t taps,
+                                    uint8_t* out, size_t n )
+  {
+    detail::active_kernels().fixed_columns_8( rows, weights, taps, out, n );
+  }
+
+  void simd_kernels::fixed_columns( const int32_t* const* rows,
+                                    const int32_t* weights, size_t taps,
+                                    uint16_t* out, size_t n )
+  {
+    detail::active_kernels().fixed_columns_16( rows, weights, taps, out, n );
+  }
+}
@@ -0,0 +1,236 @@
+#ifndef PRECISION_SIMD_KERNELS_HXX
+#define PRECISION_SIMD_KERNELS_HXX
+
+#include <cstddef>
+#include <cstdint>
+
+namespace precision {
+  /**
+   * Array kernels for the hot loops of the library.
+   *
+   * Each call is forwarded to the build selected by precision::cpu_dispatch.
+   * Arrays are in structure-of-arrays layout and must not overlap the output,
+   * unless stated otherwise.
+   *
+   * All methods are static.
+   * To prevent instantiation, constructor is private.
+   */
+  class simd_kernels {
+  public:
+    /**
+     * Computes squared distances between two arrays of points.
+     *
+     * @param x1 Coordinates in x axis for the first points.
+     * @param y1 Coordinates in y axis for the first points.
+     * @param x2 Coordinates in x axis for the second points.
+     * @param y2 Coordinates in y axis for the second points.
+     * @param out Computed squared distances.
+     * @param n Number of points.
+     */
+    static void squared_distances( const double* x1, const double* y1,
+                                   const double* x2, const double* y2,
+                                   double* out, size_t n );
+
+    /**
+     * Computes distances between two arrays of points.
+     *
+     * @param x1 Coordinates in x axis for the first points.
+     * @param y1 Coordinates in y axis for the first points.
+     * @param x2 Coordinates in x axis for the second points.
+     * @param y2 Coordinates in y axis for the second points.
+     * @param out Computed distances.
+     * @param n Number of points.
+     */
+    static void distances( const double* x1, const double* y1,
+                           const double* x2, const double* y2,
+                           double* out, size_t n );
+
+    /**
+     * Linear interpolation between two arrays of values,
+     * out = f0 + t * ( f1 - f0 ).
+     *
+     * @param f0 Values at relative distance 0.
+     * @param f1 Values at relative distance 1.
+     * @param t Relative distances.
+     * @param out Interpolated values.
+     * @param n Number of values.
+     */
+    static void linear( const double* f0, const double* f1, const double* t,
+                        double* out, size_t n );
+
+    /**
+     * Normalizes an array, out = ( in - offset ) / scale.
+     * @p out may be equal to @p in.
+     *
+     * @param in Values to normalize.
+     * @param offset Offset value.
+     * @param scale Scale value.
+     * @param out Normalized values.
+     * @param n Number of values.
+     */
+    static void normalize( const double* in, double offset, double scale,
+                           double* out, size_t n );
+
+    /**
+     * Sums the ratio between work and reference lengths for every pair
+     * of tie points.
+     *
+     * @param x Work coordinates in x axis.
+     * @param y Work coordinates in y axis.
+     * @param u Reference coordinates in x axis.
+     * @param v Reference coordinates in y axis.
+     * @param n Number of tie points.
+     * @param sum Computed sum.
+     * @return true if sucess, false if two work or reference points are equal
+     */
+    static bool pairwise_length_ratio( const double* x, const double* y,
+                                       const double* u, const double* v,
+                                       size_t n, double& sum );
+
+    /**
+     * Sums the anisomorphism ratio for every pair of tie points. Pairs
+     * aligned with one of the axes are counted in @p invalid instead.
+     *
+     * @param x Work coordinates in x axis.
+     * @param y Work coordinates in y axis.
+     * @param u Reference coordinates in x axis.
+     * @param v Reference coordinates in y axis.
+     * @param n Number of tie points.
+     * @param sum Computed sum.
+     * @param invalid Number of pairs not used.
+     */
+    static void pairwise_anisomorphism( const double* x, const double* y,
+                                        const double* u, const double* v,
+                                        size_t n, double& sum,
+                                        size_t& invalid );
+
+    /**
+     * Row band of pairwise_length_ratio: sums only the pairs (i, j), j > i,
+     * with i in [i_begin, i_end), so a large set can be split in tasks.
+     *
+     * @param i_begin First row of the band.
+     * @param i_end Row after the last row of the band.
+     * @see pairwise_length_ratio( const double*, const double*,
+     *                             const double*, const double*,
+     *                             size_t, double& )
+     */
+    static bool pairwise_length_ratio( const double* x, const double* y,
+                                       const double* u, const double* v,
+                                       size_t n, size_t i_begin, size_t i_end,
+                                       double& sum );
+
+    /**
+     * Row band of pairwise_anisomorphism.
+     *
+     * @see pairwise_length_ratio( const double*, const double*,
+     *                             const double*, const double*,
+     *                             size_t, size_t, size_t, double& )
+     */
+    static void pairwise_anisomorphism( const double* x, const double* y,
+                                        const double* u, const double* v,
+                                        size_t n, size_t i_begin,
+                                        size_t i_end, double& sum,
+                                        size_t& invalid );
+
+    /**
+     * Sums, for every triplet of tie points i < j < k, the ratio between
+     * the work and the reference angles of the vectors (i,j) and (i,k).
+     *
+     * @param x Work coordinates in x axis.
+     * @param y Work coordinates in y axis.
+     * @param u Reference coordinates in x axis.
+     * @param v Reference coordinates in y axis.
+     * @param n Number of tie points.
+     * @param sum Computed sum.
+     * @return true if sucess, false if two work or reference points are equal
+     */
+    static bool triplet_angle_ratio( const double* x, const double* y,
+                                     const double* u, const double* v,
+                                     size_t n, double& sum );
+
+    /**
+     * Row band of triplet_angle_ratio: sums only the triplets with
+     * i in [i_begin, i_end).
+     *
+     * @see pairwise_length_ratio( const double*, const double*,
+     *                             const double*, const double*,
+     *                             size_t, size_t, size_t, double& )
+     */
+    static bool triplet_angle_ratio( const double* x, const double* y,
+                                     const double* u, const double* v,
+                                     size_t n, size_t i_begin, size_t i_end,
+                                     double& sum );
+
+    /**
+     * Linear interpolation in a table of uniformly spaced nodes.
+     * Values outside the table are clamped to its range.
+     *
+     * @param f Function value at the nodes, at least 2.
+     * @param m Number of nodes.
+     * @param x0 Domain coordinate of the first node.
+     * @param step Distance between nodes.
+     * @param in Domain coordinates to interpolate at.
+     * @param out Interpolated values.
+     * @param n Number of values.
+     */
+    static void lookup_linear( const double* f, size_t m, double x0,
+                               double step, const double* in, double* out,
+                               size_t n );
+
+    /**
+     * Cubic Hermite interpolation in a table of uniformly spaced nodes
+     * (Catmull-Rom), with the central difference slope at every node and a
+     * one-sided one at the border nodes, so linear functions are exact.
+     * Values outside the table are clamped to its range.
+     *
+     * @see lookup_linear
+     */
+    static void lookup_cubic( const double* f, size_t m, double x0,
+                              double step, const double* in, double* out,
+                              size_t n );
+
+    /**
+     * Row pass of a Q14 fixed-point interpolation,
+     * out[i] = ( sum of weights[k * n + i] * in[index[i] + k] + 2^13 ) >> 14
+     * for k < taps. Results are not saturated.
+     *
+     * @param in Row samples.
+     * @param index First sample of every output value.
+     * @param weights Q14 weights, @p taps arrays of @p n weights.
+     * @param taps Number of samples per output value.
+     * @param out Interpolated values.
+     * @param n Number of values.
+     */
+    static void fixed_rows( const int32_t* in, const int32_t* index,
+                            const int32_t* weights, size_t taps,
+                            int32_t* out, size_t n );
+
+    /**
+     * Column pass of a Q14 fixed-point interpolation,
+     * out[i] = ( sum of weights[k] * rows[k][i] + 2^13 ) >> 14 for k < taps,
+     * saturated to the pixel range.
+     *
+     * @param rows @p taps rows of @p n values.
+     * @param weights @p taps Q14 weights.
+     * @param taps Number of rows.
+     * @param out Interpolated pixels.
+     * @param n Number of pixels.
+     */
+    static void fixed_columns( const int32_t* const* rows,
+                               const int32_t* weights, size_t taps,
+                               uint8_t* out, size_t n );
+
+    /**
+     * @see fixed_columns
+     */
+    static void fixed_columns( const int32_t* const* rows,
+                               const int32_t* weights, size_t taps,
+                               uint16_t* out, size_t n );
+
+  private:
+      /// Undefined constructor.
+      simd_kernels();
+  };
+}
+
+#endif // PRECISION_SIMD_KERNELS_HXX
@@ -0,0 +1,17 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+// Compiled with -mavx2 -mfma, see CMakeLists.txt.
+#include <precision/simd_kernels_body.hxx>
+
+namespace precision {
+  namespace detail {
+
+    const simd_kernel_table& avx2_kernels()
+    {
+      return kernel_table;
+    }
+  }
+}
@@ -0,0 +1,384 @@
+#ifndef PRECISION_SIMD_KERNELS_BODY_HXX
+#define PRECISION_SIMD_KERNELS_BODY_HXX
+
+/*
+ * Internal header, not installed.
+ *
+ * Kernel bodies shared by every instruction set build. Each
+ * simd_kernels_*.cxx file includes this header once and is compiled with its
+ * own target flags, so everything here has internal linkage: code generated
+ * for a wider instruction set must never be merged into the generic build.
+ *
+ * Loops are written to be vectorized by the compiler. Reductions carry an
+ * "omp simd" pragma, which needs -fopenmp-simd, since floating point sums are
+ * not reordered otherwise.
+ */
+
+#include <precision/simd_kernels_impl.hxx>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace precision {
+  namespace detail {
+    namespace {
+
+      void squared_distances( const double* x1, const double* y1,
+                              const double* x2, const double* y2,
+                              double* out, size_t n )
+      {
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          double dx = x1[i] - x2[i];
+          double dy = y1[i] - y2[i];
+          out[i] = dx * dx + dy * dy;
+        }
+      }
+
+      void distances( const double* x1, const double* y1,
+                      const double* x2, const double* y2,
+                      double* out, size_t n )
+      {
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          double dx = x1[i] - x2[i];
+          double dy = y1[i] - y2[i];
+          out[i] = std::sqrt( dx * dx + dy * dy );
+        }
+      }
+
+      void linear( const double* f0, const double* f1, const double* t,
+                   double* out, size_t n )
+      {
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          out[i] = f0[i] + t[i] * ( f1[i] - f0[i] );
+        }
+      }
+
+      void normalize( const double* in, double offset, double scale,
+                      double* out, size_t n )
+      {
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          out[i] = ( in[i] - offset ) / scale;
+        }
+      }
+
+      bool pairwise_length_ratio( const double* x, const double* y,
+                                  const double* u, const double* v,
+                                  size_t n, size_t i_begin, size_t i_end,
+                                  double& sum )
+      {
+        double total = 0.0;
+        int equal = 0;
+
+        for( size_t i = i_begin; i < i_end && i + 1 < n; i++ ) {
+          const double xi = x[i];
+          const double yi = y[i];
+          const double ui = u[i];
+          const double vi = v[i];
+
+#pragma omp simd reduction( + : total ) reduction( | : equal )
+          for( size_t j = i + 1; j < n; j++ ) {
+            double dx = xi - x[j];
+            double dy = yi - y[j];
+            double du = ui - u[j];
+            double dv = vi - v[j];
+
+            equal |= ( dx == 0.0 && dy == 0.0 ) | ( du == 0.0 && dv == 0.0 );
+            total += std::sqrt( dx * dx + dy * dy ) /
+                     std::sqrt( du * du + dv * dv );
+          }
+        }
+
+        sum = total;
+        return !equal;
+      }
+
+      void pairwise_anisomorphism( const double* x, const double* y,
+                                   const double* u, const double* v,
+                                   size_t n, size_t i_begin, size_t i_end,
+                                   double& sum, size_t& invalid )
+      {
+        double total = 0.0;
+        size_t skipped = 0;
+
+        for( size_t i = i_begin; i < i_end && i + 1 < n; i++ ) {
+          const double xi = x[i];
+          const double yi = y[i];
+          const double ui = u[i];
+          const double vi = v[i];
+
+#pragma omp simd reduction( + : total, skipped )
+          for( size_t j = i + 1; j < n; j++ ) {
+            double num_1 = std::fabs( xi - x[j] );
+            double den_1 = std::fabs( ui - u[j] );
+            double num_2 = std::fabs( yi - y[j] );
+            double den_2 = std::fabs( vi - v[j] );
+
+            double den = den_1 * num_2;
+            bool valid = den != 0.0;
+
+            // Impossible to determine anisomorphism from this points.
+            total += valid ? ( num_1 * den_2 ) / den : 0.0;
+            skipped += valid ? 0 : 1;
+          }
+        }
+
+        sum = total;
+        invalid = skipped;
+      }
+
+      /**
+       * Angle between two vectors, as precision::direction::angle.
+       */
+      inline double angle( double x1, double y1, double x2, double y2 )
+      {
+        return std::atan2( std::fabs( x1 * y2 - y1 * x2 ),
+                           x1 * x2 + y1 * y2 );
+      }
+
+      bool triplet_angle_ratio( const double* x, const double* y,
+                                const double* u, const double* v,
+                                size_t n, size_t i_begin, size_t i_end,
+                                double& sum )
+      {
+        double total = 0.0;
+
+        // atan2 has no vector version without -ffast-math, so this loop
+        // only gains from the wider arithmetic around it.
+        for( size_t i = i_begin; i < i_end && i + 2 < n; i++ ) {
+          for( size_t j = i + 1; j + 1 < n; j++ ) {
+            double xij = x[j] - x[i];
+            double yij = y[j] - y[i];
+            double uij = u[j] - u[i];
+            double vij = v[j] - v[i];
+
+            if( ( xij == 0.0 && yij == 0.0 ) || ( uij == 0.0 && vij == 0.0 ) ) {
+              return false;
+            }
+
+            for( size_t k = j + 1; k < n; k++ ) {
+              double xik = x[k] - x[i];
+              double yik = y[k] - y[i];
+              double uik = u[k] - u[i];
+              double vik = v[k] - v[i];
+
+              if( ( xik == 0.0 && yik == 0.0 ) ||
+                  ( uik == 0.0 && vik == 0.0 ) ) {
+                return false;
+              }
+
+              total += angle( xij, yij, xik, yik ) /
+                       angle( uij, vij, uik, vik );
+            }
+          }
+        }
+
+        sum = total;
+        return true;
+      }
+
+      /**
+       * Position of a value in a uniform table of m nodes, clamped to the
+       * table range. NaN values go to the first node.
+       */
+      inline double table_position( double x, double x0, double inv_step,
+                                    size_t m )
+      {
+        double t = ( x - x0 ) * inv_step;
+        double last = static_cast<double>( m - 1 );
+
+        t = ( t > 0.0 ) ? t : 0.0;
+        return ( t < last ) ? t : last;
+      }
+
+      void lookup_linear( const double* f, size_t m, double x0,
+                          double inv_step, const double* in, double* out,
+                          size_t n )
+      {
+        // 32 bit indices, double to 64 bit integer needs AVX-512DQ.
+        const int last = static_cast<int>( m ) - 2;
+
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          double t = table_position( in[i], x0, inv_step, m );
+          int k = static_cast<int>( t );
+          k = ( k < last ) ? k : last;
+
+          double u = t - k;
+          out[i] = f[k] + u * ( f[k + 1] - f[k] );
+        }
+      }
+
+      void lookup_cubic( const double* f, size_t m, double x0,
+                         double inv_step, const double* in, double* out,
+                         size_t n )
+      {
+        const int last = static_cast<int>( m ) - 2;
+
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          double t = table_position( in[i], x0, inv_step, m );
+          int k = static_cast<int>( t );
+          k = ( k < last ) ? k : last;
+
+          // Central differences, one-sided at the border nodes.
+          int k0 = ( k > 0 ) ? k - 1 : 0;
+          int k3 = ( k < last ) ? k + 2 : last + 1;
+          double d1 = ( f[k + 1] - f[k0] ) / ( k + 1 - k0 );
+          double d2 = ( f[k3] - f[k] ) / ( k3 - k );
+
+          double u = t - k;
+          double u2 = u * u;
+          double u3 = u2 * u;
+
+          out[i] = f[k] * ( 2.0 * u3 - 3.0 * u2 + 1.0 ) +
+                   d1 * ( u3 - 2.0 * u2 + u ) +
+                   f[k + 1] * ( 3.0 * u2 - 2.0 * u3 ) +
+                   d2 * ( u3 - u2 );
+        }
+      }
+
+      /**
+       * Rounds a Q14 sum to an integer, arithmetic shift so negative sums
+       * round the same way as positive ones.
+       */
+      inline int32_t fixed_round( int32_t sum )
+      {
+        return ( sum + ( 1 << 13 ) ) >> 14;
+      }
+
+      /**
+       * Row pass with a constant number of taps, so the tap loop unrolls
+       * and the pixel loop is vectorized.
+       */
+      template<size_t _PCS_TAPS>
+      void fixed_rows( const int32_t* in, const int32_t* index,
+                       const int32_t* weights, int32_t* out, size_t n )
+      {
+#pragma omp simd
+        for( size_t i = 0; i < n; i++ ) {
+          const int32_t* f = in + index[i];
+          int32_t sum = 0;
+
+          for( size_t k = 0; k < _PCS_TAPS; k++ ) {
+            sum += weights[k * n + i] * f[k];
+          }
+          out[i] = fixed_round( sum );
+        }
+      }
+
+      void fixed_rows( const int32_t* in, const int32_t* index,
+                       const int32_t* weights, size_t taps, int32_t* out,
+                       size_t n )
+      {
+        if( taps == 2 ) {
+          fixed_rows<2>( in, index, weights, out, n );
+        } else if( taps == 4 ) {
+          fixed_rows<4>( in, index, weights, out, n );
+        } else {
+          for( size_t i = 0; i < n; i++ ) {
+            const int32_t* f = in + index[i];
+            int32_t sum = 0;
+
+            for( size_t k = 0; k < taps; k++ ) {
+              sum += weights[k * n + i] * f[k];
+            }
+            out[i] = fixed_round( sum );
+          }
+        }
+      }
+
+      /**
+       * Saturates to [0, max].
+       */
+      inline int32_t fixed_saturate( int32_t r, int32_t max )
+      {
+        r = ( r > 0 ) ? r : 0;
+        return ( r < max ) ? r : max;
+      }
+
+      /**
+       * Column pass of fixed_columns_8 and fixed_columns_16, with the rows
+       * of bilinear and bicubic held in registers.
+       */
+      template<class _PCS_PIXEL>
+      void fixed_columns( const int32_t* const* rows, const int32_t* weights,
+                          size_t taps, _PCS_PIXEL* out, size_t n,
+                          int32_t max )
+      {
+        const int32_t* r0 = rows[0];
+        const int32_t w0 = weights[0];
+
+        if( taps == 2 ) {
+          const int32_t* r1 = rows[1];
+          const int32_t w1 = weights[1];
+
+#pragma omp simd
+          for( size_t i = 0; i < n; i++ ) {
+            int32_t sum = w0 * r0[i] + w1 * r1[i];
+            out[i] = static_cast<_PCS_PIXEL>(
+              fixed_saturate( fixed_round( sum ), max ) );
+          }
+        } else if( taps == 4 ) {
+          const int32_t* r1 = rows[1];
+          const int32_t* r2 = rows[2];
+          const int32_t* r3 = rows[3];
+          const int32_t w1 = weights[1];
+          const int32_t w2 = weights[2];
+          const int32_t w3 = weights[3];
+
+#pragma omp simd
+          for( size_t i = 0; i < n; i++ ) {
+            int32_t sum = w0 * r0[i] + w1 * r1[i] + w2 * r2[i] + w3 * r3[i];
+            out[i] = static_cast<_PCS_PIXEL>(
+              fixed_saturate( fixed_round( sum ), max ) );
+          }
+        } else {
+          for( size_t i = 0; i < n; i++ ) {
+            int32_t sum = 0;
+
+            for( size_t k = 0; k < taps; k++ ) {
+              sum += weights[k] * rows[k][i];
+            }
+            out[i] = static_cast<_PCS_PIXEL>(
+              fixed_saturate( fixed_round( sum ), max ) );
+          }
+        }
+      }
+
+      void fixed_columns_8( const int32_t* const* rows, const int32_t* weights,
+                            size_t taps, uint8_t* out, size_t n )
+      {
+        fixed_columns( rows, weights, taps, out, n, 0xff );
+      }
+
+      void fixed_columns_16( const int32_t* const* rows,
+                             const int32_t* weights, size_t taps,
+                             uint16_t* out, size_t n )
+      {
+        fixed_columns( rows, weights, taps, out, n, 0xffff );
+      }
+
+      const simd_kernel_table kernel_table = {
+        squared_distances,
+        distances,
+        linear,
+        normalize,
+        pairwise_length_ratio,
+        pairwise_anisomorphism,
+        triplet_angle_ratio,
+        lookup_linear,
+        lookup_cubic,
+        fixed_rows,
+        fixed_columns_8,
+        fixed_columns_16
+      };
+    }
+  }
+}
+
+#endif // PRECISION_SIMD_KERNELS_BODY_HXX
@@ -0,0 +1,16 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/simd_kernels_body.hxx>
+
+namespace precision {
+  namespace detail {
+
+    const simd_kernel_table& generic_kernels()
+    {
+      return kernel_table;
+    }
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef PRECISION_SIMD_KERNELS_IMPL_HXX
+#define PRECISION_SIMD_KERNELS_IMPL_HXX
+
+/*
+ * Internal header, not installed.
+ *
+ * Kernel table shared by precision::simd_kernels, precision::cpu_dispatch
+ * and the instruction set builds of the kernels.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace precision {
+  namespace detail {
+    /**
+     * One build of the kernels declared in precision::simd_kernels.
+     */
+    struct simd_kernel_table {
+      void ( *squared_distances )( const double*, const double*,
+                                   const double*, const double*,
+                                   double*, size_t );
+      void ( *distances )( const double*, const double*,
+                           const double*, const double*,
+                           double*, size_t );
+      void ( *linear )( const double*, const double*, const double*,
+                        double*, size_t );
+      void ( *normalize )( const double*, double, double, double*, size_t );
+      bool ( *pairwise_length_ratio )( const double*, const double*,
+                                       const double*, const double*,
+                                       size_t, size_t, size_t, double& );
+      void ( *pairwise_anisomorphism )( const double*, const double*,
+                                        const double*, const double*,
+                                        size_t, size_t, size_t,
+                                        double&, size_t& );
+      bool ( *triplet_angle_ratio )( const double*, const double*,
+                                     const double*, const double*,
+                                     size_t, size_t, size_t, double& );
+      void ( *lookup_linear )( const double*, size_t, double, double,
+                               const double*, double*, size_t );
+      void ( *lookup_cubic )( const double*, size_t, double, double,
+                              const double*, double*, size_t );
+      void ( *fixed_rows )( const int32_t*, const int32_t*, const int32_t*,
+                            size_t, int32_t*, size_t );
+      void ( *fixed_columns_8 )( const int32_t* const*, const int32_t*,
+                                 size_t, uint8_t*, size_t );
+      void ( *fixed_columns_16 )( const int32_t* const*, const int32_t*,
+                                  size_t, uint16_t*, size_t );
+    };
+
+    /// Generic build, always available.
+    const simd_kernel_table& generic_kernels();
+
+#ifdef PRECISION_X86_DISPATCH
+    /// AVX2 build.
+    const simd_kernel_table& avx2_kernels();
+
+    /// AVX-512 build.
+    const simd_kernel_table& avx512_kernels();
+#endif
+
+    /// Build selected by precision::cpu_dispatch.
+    const simd_kernel_table& active_kernels();
+  }
+}
+
+#endif // PRECISION_SIMD_KERNELS_IMPL_HXX
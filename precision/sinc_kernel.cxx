@@ -0,0 +1,59 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/sinc_kernel.hxx>
+
+namespace precision {
+  namespace {
+    const double pi = 3.14159265358979323846;
+
+    double sinc( double x )
+    {
+      if( x == 0.0 ) {
+        return 1.0;
+      }
+      return std::sin( pi * x ) / ( pi * x );
+    }
+
+    /**
+     * Window at distance x, with |x| <= radius.
+     */
+    double window_at( sinc_weights::window w, double x, double radius )
+    {
+      switch( w ) {
+      case sinc_weights::HANN:
+        return 0.5 + 0.5 * std::cos( pi * x / radius );
+      case sinc_weights::BLACKMAN:
+        return 0.42 + 0.5 * std::cos( pi * x / radius ) +
+               0.08 * std::cos( 2.0 * pi * x / radius );
+      case sinc_weights::LANCZOS:
+      default:
+        return sinc( x / radius );
+      }
+    }
+  }
+
+  void sinc_weights::compute( size_t radius, window w, double u,
+                              double* weights )
+  {
+    assert( radius > 0 );
+
+    const double r = static_cast<double>( radius );
+    double sum = 0.0;
+
+    for( size_t k = 0; k < 2 * radius; k++ ) {
+      double x = u + r - 1.0 - k;
+
+      weights[k] = ( std::fabs( x ) < r ) ? sinc( x ) * window_at( w, x, r )
+                                          : 0.0;
+      sum += weights[k];
+    }
+
+    // Normalized so flat areas keep their value.
+    for( size_t k = 0; k < 2 * radius; k++ ) {
+      weights[k] /= sum;
+    }
+  }
+}
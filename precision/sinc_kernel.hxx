@@ -0,0 +1,328 @@
+#ifndef PRECISION_SINC_KERNEL_HXX
+#define PRECISION_SINC_KERNEL_HXX
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <cassert>
+
+namespace precision {
+  /**
+   * Weights of windowed sinc kernels.
+   */
+  class sinc_weights {
+  public:
+    /**
+     * Window applied to the sinc
+     */
+    enum window {
+      LANCZOS = 0, ///< sinc( x / radius ), Lanczos kernel.
+      HANN,        ///< 0.5 + 0.5 cos( pi x / radius )
+      BLACKMAN     ///< Blackman window.
+    };
+
+    /**
+     * Computes the normalized weights of the 2 * @p radius samples around
+     * a position. Sample k is at distance u + radius - 1 - k from it, so
+     * weights[radius - 1] belongs to the sample just before the position.
+     *
+     * @param radius Kernel radius, greater than 0.
+     * @param w Window.
+     * @param u Distance from the sample before the position, in [0,1].
+     * @param weights 2 * @p radius weights, adding up to 1.
+     */
+    static void compute( size_t radius, window w, double u, double* weights );
+
+  private:
+    /// Undefined constructor.
+    sinc_weights();
+  };
+
+  namespace detail {
+    /**
+     * Weighted sum of _PCS_TAPS samples, specialized on the number of taps
+     * so the sum is fully unrolled.
+     */
+    template<size_t _PCS_TAPS>
+    struct tap_sum {
+      template<class _PCS_IMAGE>
+      static double apply( const double* w, const _PCS_IMAGE* f )
+      {
+        return tap_sum<_PCS_TAPS - 1>::apply( w, f ) +
+               w[_PCS_TAPS - 1] * f[_PCS_TAPS - 1];
+      }
+    };
+
+    template<>
+    struct tap_sum<1> {
+      template<class _PCS_IMAGE>
+      static double apply( const double* w, const _PCS_IMAGE* f )
+      {
+        return w[0] * f[0];
+      }
+    };
+  }
+
+  /**
+   * Separable windowed sinc interpolation, Lanczos by default.
+   *
+   * The weights are computed once per sub-pixel phase, so interpolation
+   * needs no sin evaluation; positions are rounded to the nearest of
+   * @p phases phases between two samples. Images are row-major, with
+   * samples at integer coordinates. Border samples are replicated and
+   * coordinates outside the image are clamped to it.
+   *
+   * Operations that must be defined:
+   * double * IMAGE, should return double
+   */
+  template<size_t _PCS_RADIUS>
+  class sinc_kernel {
+  public:
+    /// Number of samples used in each direction.
+    static const size_t TAPS = 2 * _PCS_RADIUS;
+
+    /**
+     * Default constructor.
+     *
+     * @param w Window.
+     * @param phases Number of phases between two samples, greater than 0.
+     */
+    explicit sinc_kernel( sinc_weights::window w = sinc_weights::LANCZOS,
+                          size_t phases = 256 )
+        :window_( w ), phases_( phases ), weights_( ( phases + 1 ) * TAPS )
+    {
+      assert( phases > 0 );
+
+      for( size_t i = 0; i <= phases_; i++ ) {
+        sinc_weights::compute( _PCS_RADIUS, window_,
+                               static_cast<double>( i ) / phases_,
+                               &weights_[i * TAPS] );
+      }
+    }
+
+    /**
+     * Returns the weights of the phase nearest to @p u.
+     *
+     * @param u Distance from the sample before the position, in [0,1].
+     * @return TAPS weights.
+     */
+    const double* get_weights( double u ) const
+    {
+      return &weights_[static_cast<size_t>( u * phases_ + 0.5 ) * TAPS];
+    }
+
+    /**
+     * Perform a one dimensional interpolation.
+     *
+     * @param f TAPS consecutive samples, f[_PCS_RADIUS - 1] is the sample
+     *          before the position.
+     * @param u Distance from f[_PCS_RADIUS - 1], in [0,1].
+     * @return Interpolated value.
+     */
+    template<class _PCS_IMAGE>
+    double interpolate( const _PCS_IMAGE* f, double u ) const
+    {
+      return detail::tap_sum<TAPS>::apply( get_weights( u ), f );
+    }
+
+    /**
+     * Perform a two dimensional interpolation, a row pass on TAPS rows
+     * followed by a column pass.
+     *
+     * @param image Image samples.
+     * @param width Image width, greater than 0.
+     * @param height Image height, greater than 0.
+     * @param x x-coordinate of the desired point
+     * @param y y-coordinate of the desired point
+     * @return f(x,y) of the desired point
+     */
+    template<class _PCS_IMAGE>
+    double interpolate( const _PCS_IMAGE* image, size_t width, size_t height,
+                        double x, double y ) const
+    {
+      size_t ix, iy;
+      double u = position( x, width, ix );
+      double v = position( y, height, iy );
+
+      const double* wx = get_weights( u );
+      double rows[TAPS];
+
+      if( ix + 1 >= _PCS_RADIUS && ix + _PCS_RADIUS < width ) {
+        const _PCS_IMAGE* first = image + ix + 1 - _PCS_RADIUS;
+
+        for( size_t k = 0; k < TAPS; k++ ) {
+          rows[k] = detail::tap_sum<TAPS>::apply(
+            wx, first + clamp( iy, k, height ) * width );
+        }
+      } else {
+        _PCS_IMAGE f[TAPS];
+
+        for( size_t k = 0; k < TAPS; k++ ) {
+          const _PCS_IMAGE* row = image + clamp( iy, k, height ) * width;
+
+          for( size_t l = 0; l < TAPS; l++ ) {
+            f[l] = row[clamp( ix, l, width )];
+          }
+          rows[k] = detail::tap_sum<TAPS>::apply( wx, f );
+        }
+      }
+
+      return interpolate( rows, v );
+    }
+
+    /**
+     * Resamples an image to another size. Pixel centers are aligned, so
+     * the corners of both images match.
+     *
+     * Reductions are not prefiltered, the source should be low-pass
+     * filtered before reducing it to avoid aliasing.
+     *
+     * @param src Source image.
+     * @param src_width Source width.
+     * @param src_height Source height.
+     * @param dst Resampled image, dst_width * dst_height values.
+     * @param dst_width Resampled width.
+     * @param dst_height Resampled height.
+     * @return true if sucess, false if a size is 0
+     */
+    template<class _PCS_IMAGE>
+    bool resample( const _PCS_IMAGE* src, size_t src_width, size_t src_height,
+                   double* dst, size_t dst_width, size_t dst_height ) const
+    {
+      if( !src_width || !src_height || !dst_width || !dst_height ) {
+        return false;
+      }
+
+      // Source column and weights of every resampled column.
+      std::vector<size_t> column( dst_width );
+      std::vector<const double*> wx( dst_width );
+      double scale = static_cast<double>( src_width ) / dst_width;
+
+      for( size_t i = 0; i < dst_width; i++ ) {
+        size_t ix;
+        wx[i] = get_weights( position( ( i + 0.5 ) * scale - 0.5,
+                                       src_width, ix ) );
+        column[i] = ix;
+      }
+
+      /* Row pass, on rows padded with replicated borders so the taps of
+         column[i] start at padded[column[i]] */
+      std::vector<double> padded( src_width + TAPS );
+      std::vector<double> rows( src_height * dst_width );
+
+      for( size_t j = 0; j < src_height; j++ ) {
+        const _PCS_IMAGE* row = src + j * src_width;
+
+        for( size_t i = 0; i < padded.size(); i++ ) {
+          padded[i] = row[clamp( i, 0, src_width )];
+        }
+
+        double* out = &rows[j * dst_width];
+        for( size_t i = 0; i < dst_width; i++ ) {
+          out[i] = detail::tap_sum<TAPS>::apply( wx[i], &padded[column[i]] );
+        }
+      }
+
+      /* Column pass, whole rows at a time */
+      scale = static_cast<double>( src_height ) / dst_height;
+
+      for( size_t j = 0; j < dst_height; j++ ) {
+        size_t iy;
+        const double* wy = get_weights( position( ( j + 0.5 ) * scale - 0.5,
+                                                  src_height, iy ) );
+        double* out = dst + j * dst_width;
+        const double* in = &rows[clamp( iy, 0, src_height ) * dst_width];
+
+        for( size_t i = 0; i < dst_width; i++ ) {
+          out[i] = wy[0] * in[i];
+        }
+        for( size_t k = 1; k < TAPS; k++ ) {
+          in = &rows[clamp( iy, k, src_height ) * dst_width];
+          for( size_t i = 0; i < dst_width; i++ ) {
+            out[i] += wy[k] * in[i];
+          }
+        }
+      }
+
+      return true;
+    }
+
+    /**
+     * Returns the window.
+     *
+     * @return Window.
+     */
+    sinc_weights::window get_window() const
+    {
+      return window_;
+    }
+
+    /**
+     * Returns the number of phases between two samples.
+     *
+     * @return Number of phases.
+     */
+    size_t get_phases() const
+    {
+      return phases_;
+    }
+
+  private:
+    /**
+     * Clamps a coordinate to [0, size - 1] and splits it.
+     *
+     * @param c Coordinate, NaN goes to 0.
+     * @param size Number of samples.
+     * @param index Sample before the coordinate.
+     * @return Distance from the sample, in [0,1).
+     */
+    static double position( double c, size_t size, size_t& index )
+    {
+      double last = static_cast<double>( size - 1 );
+
+      if( !( c > 0.0 ) ) {
+        c = 0.0;
+      } else if( c > last ) {
+        c = last;
+      }
+
+      double f = std::floor( c );
+      index = static_cast<size_t>( f );
+      return c - f;
+    }
+
+    /**
+     * Index of tap @p k around sample @p index, clamped to the samples.
+     *
+     * @param index Sample before the position.
+     * @param k Tap, in [0, TAPS).
+     * @param size Number of samples.
+     * @return Sample index.
+     */
+    static size_t clamp( size_t index, size_t k, size_t size )
+    {
+      size_t i = index + k + 1;
+
+      if( i < _PCS_RADIUS ) {
+        return 0;
+      }
+      i -= _PCS_RADIUS;
+      return ( i < size ) ? i : size - 1;
+    }
+
+    sinc_weights::window window_; ///< Window.
+    size_t phases_; ///< Number of phases between two samples.
+    std::vector<double> weights_; ///< TAPS weights per phase.
+  };
+
+  /// Lanczos kernel of radius 2.
+  typedef sinc_kernel<2> lanczos2_kernel;
+
+  /// Lanczos kernel of radius 3.
+  typedef sinc_kernel<3> lanczos3_kernel;
+
+  /// Lanczos kernel of radius 4.
+  typedef sinc_kernel<4> lanczos4_kernel;
+}
+
+#endif // PRECISION_SINC_KERNEL_HXX
@@ -0,0 +1,371 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/spatial_order.hxx>
+
+#include <algorithm>
+#include <cassert>
+
+namespace precision {
+  namespace {
+    /// Smallest number of items worth a task.
+    const size_t min_chunk = 1 << 14;
+
+    /// Bits of one radix sort digit, 4 passes for 2D keys.
+    const size_t digit_bits = 11;
+
+    /// Values of one radix sort digit.
+    const size_t digits = 1 << digit_bits;
+
+    /**
+     * Spreads 32 bits to the even bits of a 64 bit key.
+     */
+    inline uint64_t spread_2( uint32_t v )
+    {
+      uint64_t x = v;
+      x = ( x | ( x << 16 ) ) & 0x0000ffff0000ffffULL;
+      x = ( x | ( x << 8 ) ) & 0x00ff00ff00ff00ffULL;
+      x = ( x | ( x << 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+      x = ( x | ( x << 2 ) ) & 0x3333333333333333ULL;
+      x = ( x | ( x << 1 ) ) & 0x5555555555555555ULL;
+      return x;
+    }
+
+    /**
+     * Spreads 21 bits to every third bit of a 64 bit key.
+     */
+    inline uint64_t spread_3( uint32_t v )
+    {
+      uint64_t x = v & 0x1fffff;
+      x = ( x | ( x << 32 ) ) & 0x001f00000000ffffULL;
+      x = ( x | ( x << 16 ) ) & 0x001f0000ff0000ffULL;
+      x = ( x | ( x << 8 ) ) & 0x100f00f00f00f00fULL;
+      x = ( x | ( x << 4 ) ) & 0x10c30c30c30c30c3ULL;
+      x = ( x | ( x << 2 ) ) & 0x1249249249249249ULL;
+      return x;
+    }
+  }
+
+  spatial_order::spatial_order( curve c, size_t threads )
+      :curve_( c ), pool_( threads )
+  {
+  }
+
+  spatial_order::~spatial_order()
+  {
+  }
+
+  void spatial_order::compute( const std::vector<tie_point>& tie_points,
+                               std::vector<size_t>& permutation,
+                               space s )
+  {
+    const size_t n = tie_points.size();
+    std::vector<double> coords[2];
+    coords[0].resize( n );
+    coords[1].resize( n );
+
+    parallel_for( n, [&]( size_t, size_t begin, size_t end ) {
+        for( size_t i = begin; i < end; i++ ) {
+          point p = ( s == WORK_SPACE ) ? tie_points[i].get_xy()
+                                        : tie_points[i].get_uv();
+          coords[0][i] = p.get_x();
+          coords[1][i] = p.get_y();
+        }
+      } );
+
+    order( coords, 2, n, permutation );
+  }
+
+  void spatial_order::compute( const std::vector<point3d>& cloud,
+                               std::vector<size_t>& permutation )
+  {
+    const size_t n = cloud.size();
+    std::vector<double> coords[3];
+    coords[0].resize( n );
+    coords[1].resize( n );
+    coords[2].resize( n );
+
+    parallel_for( n, [&]( size_t, size_t begin, size_t end ) {
+        for( size_t i = begin; i < end; i++ ) {
+          cloud[i].get_xyz( coords[0][i], coords[1][i], coords[2][i] );
+        }
+      } );
+
+    order( coords, 3, n, permutation );
+  }
+
+  void spatial_order::sort( std::vector<tie_point>& tie_points,
+                            std::vector<size_t>& permutation,
+                            space s )
+  {
+    compute( tie_points, permutation, s );
+    permute( tie_points, permutation );
+  }
+
+  void spatial_order::sort( std::vector<point3d>& cloud,
+                            std::vector<size_t>& permutation )
+  {
+    compute( cloud, permutation );
+    permute( cloud, permutation );
+  }
+
+  spatial_order::curve spatial_order::get_curve() const
+  {
+    return curve_;
+  }
+
+  uint64_t spatial_order::morton_key( const uint32_t* axes, size_t dims,
+                                      size_t bits )
+  {
+    assert( dims * bits <= 64 );
+
+    if( dims == 2 ) {
+      return ( spread_2( axes[0] ) << 1 ) | spread_2( axes[1] );
+    } else if( dims == 3 ) {
+      return ( spread_3( axes[0] ) << 2 ) | ( spread_3( axes[1] ) << 1 ) |
+             spread_3( axes[2] );
+    }
+
+    uint64_t key = 0;
+
+    // Most significant bits first, the first axis leading each group.
+    for( size_t b = bits; b-- > 0; ) {
+      for( size_t a = 0; a < dims; a++ ) {
+        key = ( key << 1 ) | ( ( axes[a] >> b ) & 1 );
+      }
+    }
+
+    return key;
+  }
+
+  uint64_t spatial_order::hilbert_key( const uint32_t* axes, size_t dims,
+                                       size_t bits )
+  {
+    assert( dims <= 3 );
+    assert( bits > 0 && bits <= 32 );
+
+    /*
+     * Coordinates to the "transposed" Hilbert index of J. Skilling,
+     * Programming the Hilbert curve, AIP Conf. Proc. 707 (2004), whose
+     * interleaved bits are the key.
+     */
+    uint32_t x[3];
+    std::copy( axes, axes + dims, x );
+
+    const uint32_t m = 1u << ( bits - 1 );
+
+    // Branchless, the bits of random coordinates are not predictable.
+    for( uint32_t q = m; q > 1; q >>= 1 ) {
+      const uint32_t p = q - 1;
+
+      for( size_t a = 0; a < dims; a++ ) {
+        // All ones if the bit is set: invert the low bits of x[0],
+        // otherwise exchange the low bits of x[0] and x[a].
+        uint32_t set = 0u - ( ( x[a] & q ) != 0 );
+        uint32_t t = ( x[0] ^ x[a] ) & p & ~set;
+        x[0] ^= ( p & set ) | t;
+        x[a] ^= t;
+      }
+    }
+
+    // Gray encode.
+    for( size_t a = 1; a < dims; a++ ) {
+      x[a] ^= x[a - 1];
+    }
+
+    uint32_t t = 0;
+    for( uint32_t q = m; q > 1; q >>= 1 ) {
+      t ^= ( q - 1 ) & ( 0u - ( ( x[dims - 1] & q ) != 0 ) );
+    }
+    for( size_t a = 0; a < dims; a++ ) {
+      x[a] ^= t;
+    }
+
+    return morton_key( x, dims, bits );
+  }
+
+  size_t spatial_order::get_chunks( size_t n ) const
+  {
+    size_t chunks = ( n + min_chunk - 1 ) / min_chunk;
+    return std::max<size_t>( 1, std::min( chunks, pool_.get_threads() ) );
+  }
+
+  void spatial_order::parallel_for( size_t n, const range_task& f )
+  {
+    const size_t chunks = get_chunks( n );
+
+    if( chunks == 1 ) {
+      f( 0, 0, n );
+      return;
+    }
+
+    for( size_t c = 0; c < chunks; c++ ) {
+      size_t begin = n * c / chunks;
+      size_t end = n * ( c + 1 ) / chunks;
+      pool_.submit( [&f, c, begin, end]() { f( c, begin, end ); } );
+    }
+
+    pool_.wait();
+  }
+
+  void spatial_order::order( const std::vector<double>* coords, size_t dims,
+                             size_t n, std::vector<size_t>& permutation )
+  {
+    const size_t bits = ( dims == 2 ) ? 22 : 21;
+    const size_t chunks = get_chunks( n );
+
+    /* Bounding box, NaN coordinates are ignored */
+    std::vector<double> low( chunks * dims ), high( chunks * dims );
+
+    parallel_for( n, [&]( size_t c, size_t begin, size_t end ) {
+        for( size_t a = 0; a < dims; a++ ) {
+          double lo = 0.0, hi = -1.0;
+
+          for( size_t i = begin; i < end; i++ ) {
+            double v = coords[a][i];
+            if( !( hi >= lo ) ) {
+              lo = hi = v;
+            } else if( v < lo ) {
+              lo = v;
+            } else if( v > hi ) {
+              hi = v;
+            }
+          }
+
+          low[c * dims + a] = lo;
+          high[c * dims + a] = hi;
+        }
+      } );
+
+    const double limit = static_cast<double>( ( uint64_t( 1 ) << bits ) - 1 );
+    double origin[3] = { 0.0, 0.0, 0.0 }, scale[3] = { 0.0, 0.0, 0.0 };
+
+    for( size_t a = 0; a < dims; a++ ) {
+      double lo = 0.0, hi = -1.0;
+
+      for( size_t c = 0; c < chunks; c++ ) {
+        double l = low[c * dims + a], h = high[c * dims + a];
+        if( !( h >= l ) ) {
+          continue;
+        }
+        if( !( hi >= lo ) ) {
+          lo = l;
+          hi = h;
+        } else {
+          lo = std::min( lo, l );
+          hi = std::max( hi, h );
+        }
+      }
+
+      origin[a] = lo;
+      scale[a] = ( hi > lo ) ? limit / ( hi - lo ) : 0.0;
+    }
+
+    /* Keys */
+    std::vector<uint64_t> keys( n );
+    permutation.resize( n );
+
+    parallel_for( n, [&]( size_t, size_t begin, size_t end ) {
+        uint32_t q[3];
+
+        for( size_t i = begin; i < end; i++ ) {
+          for( size_t a = 0; a < dims; a++ ) {
+            double t = ( coords[a][i] - origin[a] ) * scale[a];
+            q[a] = !( t > 0.0 ) ? 0 :
+              ( t < limit ? static_cast<uint32_t>( t )
+                          : static_cast<uint32_t>( limit ) );
+          }
+
+          keys[i] = ( curve_ == HILBERT ) ? hilbert_key( q, dims, bits )
+                                          : morton_key( q, dims, bits );
+          permutation[i] = i;
+        }
+      } );
+
+    radix_sort( keys, permutation, dims * bits );
+  }
+
+  void spatial_order::radix_sort( std::vector<uint64_t>& keys,
+                                  std::vector<size_t>& indices,
+                                  size_t key_bits )
+  {
+    const size_t n = keys.size();
+    const size_t chunks = get_chunks( n );
+    const size_t passes = ( key_bits + digit_bits - 1 ) / digit_bits;
+    const uint64_t mask = digits - 1;
+
+    /* Histograms of every pass in a single read of the keys. The chunks
+       hold other keys once the first pass has moved them, so with more than
+       one chunk the later histograms are counted again before their pass */
+    std::vector<size_t> counts( chunks * passes * digits, 0 );
+
+    parallel_for( n, [&]( size_t c, size_t begin, size_t end ) {
+        size_t* count = &counts[c * passes * digits];
+        for( size_t i = begin; i < end; i++ ) {
+          uint64_t key = keys[i];
+          for( size_t p = 0; p < passes; p++ ) {
+            count[p * digits + ( ( key >> ( p * digit_bits ) ) & mask )]++;
+          }
+        }
+      } );
+
+    std::vector<uint64_t> keys_tmp( n );
+    std::vector<size_t> indices_tmp( n );
+
+    for( size_t p = 0; p < passes; p++ ) {
+      const size_t shift = p * digit_bits;
+
+      if( p > 0 && chunks > 1 ) {
+        parallel_for( n, [&]( size_t c, size_t begin, size_t end ) {
+            size_t* count = &counts[( c * passes + p ) * digits];
+            std::fill( count, count + digits, 0 );
+            for( size_t i = begin; i < end; i++ ) {
+              count[( keys[i] >> shift ) & mask]++;
+            }
+          } );
+      }
+
+      // Chunk c writes its keys of digit d after the keys of smaller
+      // digits and after the keys of digit d of the chunks before it.
+      size_t total = 0;
+      bool single = false;
+
+      for( size_t d = 0; d < digits; d++ ) {
+        size_t start = total;
+
+        for( size_t c = 0; c < chunks; c++ ) {
+          size_t& count = counts[( c * passes + p ) * digits + d];
+          size_t keys_of_digit = count;
+          count = total;
+          total += keys_of_digit;
+        }
+
+        single = single || ( total - start == n );
+      }
+
+      // Every key has the same digit, nothing moves.
+      if( single ) {
+        continue;
+      }
+
+      parallel_for( n, [&]( size_t c, size_t begin, size_t end ) {
+          size_t* offset = &counts[( c * passes + p ) * digits];
+          const uint64_t* in_keys = &keys[0];
+          const size_t* in_indices = &indices[0];
+          uint64_t* out_keys = &keys_tmp[0];
+          size_t* out_indices = &indices_tmp[0];
+
+          for( size_t i = begin; i < end; i++ ) {
+            size_t o = offset[( in_keys[i] >> shift ) & mask]++;
+            out_keys[o] = in_keys[i];
+            out_indices[o] = in_indices[i];
+          }
+        } );
+
+      keys.swap( keys_tmp );
+      indices.swap( indices_tmp );
+    }
+  }
+}
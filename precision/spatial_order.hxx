@@ -0,0 +1,201 @@
+#ifndef PRECISION_SPATIAL_ORDER_HXX
+#define PRECISION_SPATIAL_ORDER_HXX
+
+#include <precision/point3d.hxx>
+#include <precision/tie_point.hxx>
+#include <precision/work_stealing_pool.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace precision {
+  /**
+   * Space-filling curve ordering of tie points and point clouds.
+   *
+   * Coordinates are quantized on their bounding box, 22 bits per axis for
+   * tie points and 21 bits per axis for point3d clouds, and turned into
+   * Morton (Z-order) or Hilbert keys. A parallel LSD radix sort on the keys
+   * gives the permutation, so points close in space end up close in memory.
+   * The sort is stable: points with the same key keep their order.
+   *
+   * Permutations are gathers, sorted[i] = original[permutation[i]].
+   */
+  class spatial_order {
+  public:
+    /**
+     * Space-filling curve
+     */
+    enum curve {
+      MORTON = 0, ///< Z-order, bit interleaving.
+      HILBERT ///< Hilbert curve, no jumps between neighbour keys.
+    };
+
+    /**
+     * Tie point coordinates to order by
+     */
+    enum space {
+      WORK_SPACE = 0, ///< Work points, x/y.
+      REFERENCE_SPACE ///< Reference points, u/v.
+    };
+
+    /**
+     * Default constructor.
+     *
+     * @param c Space-filling curve.
+     * @param threads Number of workers, 0 for one per hardware thread.
+     */
+    explicit spatial_order( curve c = HILBERT, size_t threads = 0 );
+
+    /**
+     * Default destructor.
+     */
+    ~spatial_order();
+
+    /**
+     * Computes the permutation that orders tie points along the curve.
+     *
+     * @param tie_points Tie points.
+     * @param permutation Computed permutation.
+     * @param s Coordinates to order by.
+     */
+    void compute( const std::vector<tie_point>& tie_points,
+                  std::vector<size_t>& permutation,
+                  space s = WORK_SPACE );
+
+    /**
+     * Computes the permutation that orders a point cloud along the curve,
+     * in three dimensions.
+     *
+     * @param cloud Points.
+     * @param permutation Computed permutation.
+     */
+    void compute( const std::vector<point3d>& cloud,
+                  std::vector<size_t>& permutation );
+
+    /**
+     * Orders tie points along the curve.
+     *
+     * @param tie_points Tie points, reordered.
+     * @param permutation Applied permutation.
+     * @param s Coordinates to order by.
+     */
+    void sort( std::vector<tie_point>& tie_points,
+               std::vector<size_t>& permutation,
+               space s = WORK_SPACE );
+
+    /**
+     * Orders a point cloud along the curve.
+     *
+     * @param cloud Points, reordered.
+     * @param permutation Applied permutation.
+     */
+    void sort( std::vector<point3d>& cloud, std::vector<size_t>& permutation );
+
+    /**
+     * Reorders values with a permutation, for arrays that go along the
+     * sorted points.
+     *
+     * @param values Values, reordered.
+     * @param permutation Permutation of the same size.
+     */
+    template<class _PCS_TYPE>
+    void permute( std::vector<_PCS_TYPE>& values,
+                  const std::vector<size_t>& permutation )
+    {
+      std::vector<_PCS_TYPE> sorted( values.size() );
+      const size_t n = values.size();
+
+      parallel_for( n, [&]( size_t, size_t begin, size_t end ) {
+          for( size_t i = begin; i < end; i++ ) {
+            sorted[i] = values[permutation[i]];
+          }
+        } );
+
+      values.swap( sorted );
+    }
+
+    /**
+     * Returns the space-filling curve.
+     *
+     * @return Space-filling curve.
+     */
+    curve get_curve() const;
+
+    /**
+     * Morton key of quantized coordinates.
+     *
+     * @param axes Coordinates, @p bits bits each.
+     * @param dims Number of axes, 2 or 3.
+     * @param bits Bits per axis, up to 64 / @p dims.
+     * @return Key of dims * bits bits.
+     */
+    static uint64_t morton_key( const uint32_t* axes, size_t dims,
+                                size_t bits );
+
+    /**
+     * Hilbert key of quantized coordinates.
+     *
+     * @see morton_key
+     */
+    static uint64_t hilbert_key( const uint32_t* axes, size_t dims,
+                                 size_t bits );
+
+  private:
+    /// Undefined copy constructor.
+    spatial_order( const spatial_order& );
+
+    /// Undefined assignment operator.
+    spatial_order& operator = ( const spatial_order& );
+
+    /**
+     * Range task of parallel_for, called with the chunk index, the first
+     * item and the item after the last.
+     */
+    typedef std::function<void( size_t, size_t, size_t )> range_task;
+
+    /**
+     * Returns the number of chunks parallel_for splits n items in.
+     *
+     * @param n Number of items.
+     * @return Number of chunks, at least 1.
+     */
+    size_t get_chunks( size_t n ) const;
+
+    /**
+     * Runs a task on get_chunks( n ) consecutive ranges of [0, n) on the
+     * workers and waits for them. A single chunk runs on the calling thread.
+     *
+     * @param n Number of items.
+     * @param f Task.
+     */
+    void parallel_for( size_t n, const range_task& f );
+
+    /**
+     * Computes keys of quantized coordinates and sorts them.
+     *
+     * @param coords dims arrays of n coordinates.
+     * @param dims Number of axes, 2 or 3.
+     * @param n Number of points.
+     * @param permutation Computed permutation.
+     */
+    void order( const std::vector<double>* coords, size_t dims, size_t n,
+                std::vector<size_t>& permutation );
+
+    /**
+     * Stable LSD radix sort of keys, carrying their indices.
+     *
+     * @param keys Keys, sorted.
+     * @param indices Indices, in key order.
+     * @param key_bits Bits used by the keys.
+     */
+    void radix_sort( std::vector<uint64_t>& keys,
+                     std::vector<size_t>& indices, size_t key_bits );
+
+    curve curve_; ///< Space-filling curve.
+    work_stealing_pool pool_; ///< Workers.
+  };
+}
+
+#endif // PRECISION_SPATIAL_ORDER_HXX
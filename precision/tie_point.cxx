@@ -5,7 +5,7 @@
 
 #include <precision/tie_point.hxx>
 
-#include <cmath>
+#include <memory>
 
 namespace precision {
 
@@ -70,99 +70,22 @@ namespace precision {
   tie_point::remove_duplicate_points
   ( std::vector<precision::tie_point>& registered_points, double max_dif )
   {
-    precision::point work_point1;
-    precision::point ref_point1;
-    precision::point work_point2;
-    precision::point ref_point2;
-
-    std::vector<precision::tie_point>::iterator rg_i = registered_points.begin();
-
-    for( size_t i = 0; i + 1 < registered_points.size(); ) {
-      (*rg_i).get( work_point1, ref_point1 );
-      bool work_coord_equal = true;
-      
-      std::vector<precision::tie_point>::iterator rg_j = rg_i + 1;
-      for( size_t j = i+1; j < registered_points.size();  ) {
-        (*rg_j).get( work_point2, ref_point2 );
-        // Testing if there are equal reference points
-        if( ref_point1 == ref_point2 ) {
-
-          // Testing if work points are equal
-          if( ( fabs( work_point1.get_x() - work_point2.get_x() ) > max_dif ) ||
-              ( fabs( work_point1.get_y() - work_point2.get_y() ) > max_dif ) ){
-            work_coord_equal = false;
-          }
-          // Removing the duplicated tie point
-          registered_points.erase( rg_j );
-        } else {
-          j++;
-          rg_j++;
-        }
-      }
-      // If work coordinates of duplicated tie points are differente,
-      // both are removed
-      if( !work_coord_equal ) {
-        registered_points.erase( rg_i );
-      } else {
-        i++;
-        rg_i++;
-      }
-    }
+    remove_duplicate_points< std::allocator<tie_point> >( registered_points,
+                                                          max_dif );
   }
 
   void tie_point::compute_origins( const std::list<tie_point>& tie_points,
                                    point& xy0,
                                    point& uv0 )
   {
-    double x0 = 0.;
-    double y0 = 0.;
-
-    double u0 = 0.;
-    double v0 = 0.;
-
-    size_t n = 0;
-
-    std::list<precision::tie_point>::const_iterator it;
-    for( it = tie_points.begin(); it != tie_points.end(); it++ ) {
-
-      if( it->get_type() == tie_point::CONTROL ||
-              it->get_type() == tie_point::CONTROL_CHECK ) {
-
-        precision::point u_v, x_y;
-        it->get( x_y, u_v );
-
-        x0 += x_y.get_x();
-        y0 += x_y.get_y();
-
-        u0 += u_v.get_x();
-        v0 += u_v.get_y();
-
-        ++n;
-      }
-    }
-
-    xy0 = precision::point( x0 / n, y0 / n );
-    uv0 = precision::point( u0 / n, v0 / n );
+    compute_origins< std::allocator<tie_point> >( tie_points, xy0, uv0 );
   }
 
   void tie_point::change_origins( std::list<precision::tie_point>& tie_points,
                                   const point& xy0,
                                   const point& uv0 )
   {
-    std::list<precision::tie_point>::iterator it;
-    for( it = tie_points.begin(); it != tie_points.end(); it++ ) {
-      precision::point u_v, x_y;
-      it->get( x_y, u_v );
-
-      // changing work-point origin
-      x_y -= xy0;
-
-      // changing reference-point origin
-      u_v -= uv0;
-
-      it->set_xy( x_y );
-      it->set_uv( u_v );
-    }
+    change_origins< std::allocator<tie_point> >( tie_points, xy0, uv0 );
   }
 
   std::ostream& operator <<( std::ostream& os, const tie_point& tp )
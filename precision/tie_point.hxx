@@ -2,8 +2,10 @@
 #ifndef PRECISION_TIE_POINT_HXX
 #define PRECISION_TIE_POINT_HXX
 
+#include <precision/monotonic_arena.hxx>
 #include <precision/point.hxx>
 
+#include <cmath>
 #include <list>
 #include <ostream>
 #include <string>
@@ -145,6 +147,16 @@ namespace precision {
     static void remove_duplicate_points
       ( std::vector<precision::tie_point>& registered_points, double max_dif );
 
+    /**
+     * Removes duplicated tie-points in a vector with any allocator.
+     *
+     * @see remove_duplicate_points( std::vector<precision::tie_point>&, double )
+     */
+    template<class _PCS_ALLOC>
+    static void remove_duplicate_points
+      ( std::vector<precision::tie_point, _PCS_ALLOC>& registered_points,
+        double max_dif );
+
     /**
      * Compute origin for work and reference-points.
      *
@@ -156,6 +168,30 @@ namespace precision {
                                  point& xy0,
                                  point& uv0 );
 
+    /**
+     * Compute origin for work and reference-points of a list with any
+     * allocator.
+     *
+     * @see compute_origins( const std::list<tie_point>&, point&, point& )
+     */
+    template<class _PCS_ALLOC>
+    static void compute_origins
+      ( const std::list<tie_point, _PCS_ALLOC>& tie_points,
+        point& xy0,
+        point& uv0 );
+
+    /**
+     * Compute origin for work and reference-points of a vector with any
+     * allocator.
+     *
+     * @see compute_origins( const std::list<tie_point>&, point&, point& )
+     */
+    template<class _PCS_ALLOC>
+    static void compute_origins
+      ( const std::vector<tie_point, _PCS_ALLOC>& tie_points,
+        point& xy0,
+        point& uv0 );
+
     /**
      * Change work and reference-points origin.
      *
@@ -167,6 +203,31 @@ namespace precision {
                                 const point& xy0,
                                 const point& uv0 );
 
+    /**
+     * Change work and reference-points origin of a list with any allocator.
+     *
+     * @see change_origins( std::list<precision::tie_point>&, const point&,
+     *                      const point& )
+     */
+    template<class _PCS_ALLOC>
+    static void change_origins
+      ( std::list<precision::tie_point, _PCS_ALLOC>& tie_points,
+        const point& xy0,
+        const point& uv0 );
+
+    /**
+     * Change work and reference-points origin of a vector with any
+     * allocator.
+     *
+     * @see change_origins( std::list<precision::tie_point>&, const point&,
+     *                      const point& )
+     */
+    template<class _PCS_ALLOC>
+    static void change_origins
+      ( std::vector<precision::tie_point, _PCS_ALLOC>& tie_points,
+        const point& xy0,
+        const point& uv0 );
+
     /**
      * Ostream operator to help debugging, so we can use
      * precision::to_string<point>().
@@ -178,6 +239,32 @@ namespace precision {
     friend std::ostream& operator <<( std::ostream& os, const tie_point& tp );
 
   private :
+    /**
+     * Compute origin for work and reference-points of a range.
+     *
+     * @param first First tie-point.
+     * @param last Tie-point after the last.
+     * @param xy0 Work-points origin.
+     * @param uv0 Reference-points origin.
+     */
+    template<class _PCS_ITERATOR>
+    static void compute_origins( _PCS_ITERATOR first, _PCS_ITERATOR last,
+                                 point& xy0,
+                                 point& uv0 );
+
+    /**
+     * Change work and reference-points origin of a range.
+     *
+     * @param first First tie-point.
+     * @param last Tie-point after the last.
+     * @param xy0 New work-points origin.
+     * @param uv0 New reference-points origin.
+     */
+    template<class _PCS_ITERATOR>
+    static void change_origins( _PCS_ITERATOR first, _PCS_ITERATOR last,
+                                const point& xy0,
+                                const point& uv0 );
+
     /// Original image point coords
     precision::point x_y_ ;
 
@@ -187,6 +274,154 @@ namespace precision {
     /// Point type
     type type_;
   };
+
+  /// Tie-point list taking its memory from a precision::monotonic_arena.
+  typedef std::list<tie_point, arena_allocator<tie_point> > tie_point_arena_list;
+
+  /// Tie-point vector taking its memory from a precision::monotonic_arena.
+  typedef std::vector<tie_point, arena_allocator<tie_point> >
+    tie_point_arena_vector;
+
+  template<class _PCS_ALLOC>
+  void
+  tie_point::remove_duplicate_points
+  ( std::vector<precision::tie_point, _PCS_ALLOC>& registered_points,
+    double max_dif )
+  {
+    precision::point work_point1;
+    precision::point ref_point1;
+    precision::point work_point2;
+    precision::point ref_point2;
+
+    typename std::vector<precision::tie_point, _PCS_ALLOC>::iterator rg_i =
+      registered_points.begin();
+
+    for( size_t i = 0; i + 1 < registered_points.size(); ) {
+      (*rg_i).get( work_point1, ref_point1 );
+      bool work_coord_equal = true;
+      
+      typename std::vector<precision::tie_point, _PCS_ALLOC>::iterator rg_j =
+        rg_i + 1;
+      for( size_t j = i+1; j < registered_points.size();  ) {
+        (*rg_j).get( work_point2, ref_point2 );
+        // Testing if there are equal reference points
+        if( ref_point1 == ref_point2 ) {
+
+          // Testing if work points are equal
+          if( ( std::fabs( work_point1.get_x() - work_point2.get_x() )
+                  > max_dif ) ||
+              ( std::fabs( work_point1.get_y() - work_point2.get_y() )
+                  > max_dif ) ){
+            work_coord_equal = false;
+          }
+          // Removing the duplicated tie point
+          registered_points.erase( rg_j );
+        } else {
+          j++;
+          rg_j++;
+        }
+      }
+      // If work coordinates of duplicated tie points are differente,
+      // both are removed
+      if( !work_coord_equal ) {
+        registered_points.erase( rg_i );
+      } else {
+        i++;
+        rg_i++;
+      }
+    }
+  }
+
+  template<class _PCS_ITERATOR>
+  void tie_point::compute_origins( _PCS_ITERATOR first, _PCS_ITERATOR last,
+                                   point& xy0,
+                                   point& uv0 )
+  {
+    double x0 = 0.;
+    double y0 = 0.;
+
+    double u0 = 0.;
+    double v0 = 0.;
+
+    size_t n = 0;
+
+    for( _PCS_ITERATOR it = first; it != last; it++ ) {
+
+      if( it->get_type() == tie_point::CONTROL ||
+              it->get_type() == tie_point::CONTROL_CHECK ) {
+
+        precision::point u_v, x_y;
+        it->get( x_y, u_v );
+
+        x0 += x_y.get_x();
+        y0 += x_y.get_y();
+
+        u0 += u_v.get_x();
+        v0 += u_v.get_y();
+
+        ++n;
+      }
+    }
+
+    xy0 = precision::point( x0 / n, y0 / n );
+    uv0 = precision::point( u0 / n, v0 / n );
+  }
+
+  template<class _PCS_ITERATOR>
+  void tie_point::change_origins( _PCS_ITERATOR first, _PCS_ITERATOR last,
+                                  const point& xy0,
+                                  const point& uv0 )
+  {
+    for( _PCS_ITERATOR it = first; it != last; it++ ) {
+      precision::point u_v, x_y;
+      it->get( x_y, u_v );
+
+      // changing work-point origin
+      x_y -= xy0;
+
+      // changing reference-point origin
+      u_v -= uv0;
+
+      it->set_xy( x_y );
+      it->set_uv( u_v );
+    }
+  }
+
+  template<class _PCS_ALLOC>
+  void tie_point::compute_origins
+    ( const std::list<tie_point, _PCS_ALLOC>& tie_points,
+      point& xy0,
+      point& uv0 )
+  {
+    compute_origins( tie_points.begin(), tie_points.end(), xy0, uv0 );
+  }
+
+  template<class _PCS_ALLOC>
+  void tie_point::compute_origins
+    ( const std::vector<tie_point, _PCS_ALLOC>& tie_points,
+      point& xy0,
+      point& uv0 )
+  {
+    compute_origins( tie_points.begin(), tie_points.end(), xy0, uv0 );
+  }
+
+  template<class _PCS_ALLOC>
+  void tie_point::change_origins
+    ( std::list<precision::tie_point, _PCS_ALLOC>& tie_points,
+      const point& xy0,
+      const point& uv0 )
+  {
+    change_origins( tie_points.begin(), tie_points.end(), xy0, uv0 );
+  }
+
+  template<class _PCS_ALLOC>
+  void tie_point::change_origins
+    ( std::vector<precision::tie_point, _PCS_ALLOC>& tie_points,
+      const point& xy0,
+      const point& uv0 )
+  {
+    change_origins( tie_points.begin(), tie_points.end(), xy0, uv0 );
+  }
 }
 
 #endif // PRECISION_TIE_POINT_HXX
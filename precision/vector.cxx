@@ -4,9 +4,10 @@
 #endif
 
 #include <precision/vector.hxx>
+#include <precision/direction.hxx>
 
-#include <cmath>
 #include <cassert>
+#include <limits>
 
 namespace precision {
 
@@ -64,30 +65,19 @@ namespace precision {
     return p2_;
   }
 
-  double vector::length_vector()
+  double vector::length_vector() const
   {
-    return std::sqrt( std::pow( p1_.get_x() - p2_.get_x(), 2 ) +
-                      std::pow( p1_.get_y() - p2_.get_y(), 2 ) );
+    return direction( p1_, p2_ ).length();
   }
 
-  double vector::angle_b_vectors( const vector& v )
+  double vector::angle_b_vectors( const vector& v ) const
   {
-    point p1_v, p2_v;
+    double a;
 
-    v.get( p1_v, p2_v );
-
-    double x1, y1, x2, y2;
-
-    x1 = p2_.get_x() - p1_.get_x();
-    y1 = p2_.get_y() - p1_.get_y();
-
-    x2 = p2_v.get_x() - p1_v.get_x();
-    y2 = p2_v.get_y() - p1_v.get_y();
-
-    return std::acos( ( ( x1 * x2 ) + ( y1 * y2 ) ) /
-                 ( std::sqrt( std::pow( x1, 2 ) + std::pow( y1, 2 ) ) *
-                   std::sqrt( std::pow( x2, 2 ) + std::pow( y2, 2 ) )
-                 )
-               );
+    // A null vector has no angle, as direction::angles() reports it.
+    if( !direction( p1_, p2_ ).angle( direction( v.p1_, v.p2_ ), a ) ) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    return a;
   }
 }
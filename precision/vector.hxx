@@ -72,14 +72,14 @@ namespace precision {
      *
      * @return vector_length
      */
-    double length_vector();
+    double length_vector() const;
 
     /**
      * Estimates the angle between two vectors.
      *
-     * @return angle_b_vectors
+     * @return angle_b_vectors, NaN if a vector is null
      */
-    double angle_b_vectors( const vector& v );
+    double angle_b_vectors( const vector& v ) const;
 
   private:
     /**
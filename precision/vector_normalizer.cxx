@@ -4,6 +4,7 @@
 #endif
 
 #include <precision/vector_normalizer.hxx>
+#include <precision/simd_kernels.hxx>
 
 #include <cmath>
 #include <cstddef>
@@ -25,10 +26,11 @@ namespace precision {
     double offset = get_offset();
     double scale = get_scale();
 
-    std::vector<double> v_normalized;
+    std::vector<double> v_normalized( to_normalize_.size() );
 
-    for( size_t i=0; i < to_normalize_.size(); i++ ) {
-      v_normalized.push_back( ( to_normalize_[i] - offset ) / scale );
+    if( !v_normalized.empty() ) {
+      simd_kernels::normalize( &to_normalize_[0], offset, scale,
+                               &v_normalized[0], v_normalized.size() );
     }
 
     return v_normalized;
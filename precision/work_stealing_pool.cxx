@@ -0,0 +1,151 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <precision/work_stealing_pool.hxx>
+
+namespace precision {
+  namespace {
+    /// Pool of the worker running on this thread, if any.
+    thread_local const work_stealing_pool* current_pool = 0;
+
+    /// Index of the worker running on this thread.
+    thread_local size_t current_worker = 0;
+  }
+
+  work_stealing_pool::work_stealing_pool( size_t threads )
+      :queued_( 0 ), pending_( 0 ), next_queue_( 0 ), stop_( false )
+  {
+    if( threads == 0 ) {
+      threads = std::thread::hardware_concurrency();
+    }
+    if( threads == 0 ) {
+      threads = 1;
+    }
+
+    for( size_t i = 0; i < threads; i++ ) {
+      queues_.push_back( new queue );
+    }
+    for( size_t i = 0; i < threads; i++ ) {
+      workers_.push_back( std::thread( &work_stealing_pool::run, this, i ) );
+    }
+  }
+
+  work_stealing_pool::~work_stealing_pool()
+  {
+    wait();
+
+    {
+      std::lock_guard<std::mutex> lock( mutex_ );
+      stop_ = true;
+    }
+    work_available_.notify_all();
+
+    for( size_t i = 0; i < workers_.size(); i++ ) {
+      workers_[i].join();
+    }
+    for( size_t i = 0; i < queues_.size(); i++ ) {
+      delete queues_[i];
+    }
+  }
+
+  void work_stealing_pool::submit( const task& t )
+  {
+    size_t index;
+
+    if( current_pool == this ) {
+      index = current_worker;
+    } else {
+      index = next_queue_++ % queues_.size();
+    }
+
+    pending_++;
+    {
+      // Counted under the queue lock, so a thief never takes the task
+      // before it is counted and wraps queued_ around.
+      std::lock_guard<std::mutex> lock( queues_[index]->mutex );
+      queued_++;
+      queues_[index]->tasks.push_back( t );
+    }
+
+    // Taking mutex_ orders the notification after a worker that just saw
+    // no work has gone to sleep.
+    {
+      std::lock_guard<std::mutex> lock( mutex_ );
+    }
+    work_available_.notify_one();
+  }
+
+  void work_stealing_pool::wait()
+  {
+    std::unique_lock<std::mutex> lock( mutex_ );
+    while( pending_ != 0 ) {
+      all_done_.wait( lock );
+    }
+  }
+
+  size_t work_stealing_pool::get_threads() const
+  {
+    return workers_.size();
+  }
+
+  void work_stealing_pool::run( size_t index )
+  {
+    current_pool = this;
+    current_worker = index;
+
+    task t;
+    for( ;; ) {
+      if( take( index, t ) ) {
+        t();
+        t = task();
+
+        if( --pending_ == 0 ) {
+          std::lock_guard<std::mutex> lock( mutex_ );
+          all_done_.notify_all();
+        }
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock( mutex_ );
+      while( queued_ == 0 && !stop_ ) {
+        work_available_.wait( lock );
+      }
+      if( queued_ == 0 && stop_ ) {
+        return;
+      }
+    }
+  }
+
+  bool work_stealing_pool::take( size_t index, task& t )
+  {
+    const size_t n = queues_.size();
+
+    // Own queue first, newest task.
+    {
+      queue& own = *queues_[index];
+      std::lock_guard<std::mutex> lock( own.mutex );
+      if( !own.tasks.empty() ) {
+        t.swap( own.tasks.back() );
+        own.tasks.pop_back();
+        queued_--;
+        return true;
+      }
+    }
+
+    // Then steal the oldest task of the other queues.
+    for( size_t i = 1; i < n; i++ ) {
+      queue& victim = *queues_[( index + i ) % n];
+      std::lock_guard<std::mutex> lock( victim.mutex );
+      if( !victim.tasks.empty() ) {
+        t.swap( victim.tasks.front() );
+        victim.tasks.pop_front();
+        queued_--;
+        return true;
+      }
+    }
+
+    return false;
+  }
+}
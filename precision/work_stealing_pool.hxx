@@ -0,0 +1,106 @@
+#ifndef PRECISION_WORK_STEALING_POOL_HXX
+#define PRECISION_WORK_STEALING_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace precision {
+  /**
+   * Thread pool with one task queue per worker.
+   *
+   * A worker runs the newest task of its own queue first and, when it is
+   * empty, steals the oldest task of another queue. Tasks submitted from
+   * inside a task go to the queue of the worker running it, so a task that
+   * splits its work keeps the pieces local until other workers go idle.
+   */
+  class work_stealing_pool {
+  public:
+    /**
+     * Task to run
+     */
+    typedef std::function<void()> task;
+
+    /**
+     * Default constructor.
+     *
+     * @param threads Number of workers, 0 for one per hardware thread.
+     */
+    explicit work_stealing_pool( size_t threads = 0 );
+
+    /**
+     * Destructor. Waits for the queued tasks and stops the workers.
+     */
+    ~work_stealing_pool();
+
+    /**
+     * Queues a task. It can be called from inside a task.
+     *
+     * @param t Task to run.
+     */
+    void submit( const task& t );
+
+    /**
+     * Waits until every queued task, including the ones submitted by other
+     * tasks, has finished. It must not be called from inside a task.
+     */
+    void wait();
+
+    /**
+     * Returns the number of workers.
+     *
+     * @return Number of workers.
+     */
+    size_t get_threads() const;
+
+  private:
+    /// Undefined copy constructor.
+    work_stealing_pool( const work_stealing_pool& );
+
+    /// Undefined assignment operator.
+    work_stealing_pool& operator = ( const work_stealing_pool& );
+
+    /**
+     * Worker task queue
+     */
+    struct queue {
+      std::mutex mutex; ///< Protects tasks.
+      std::deque<task> tasks; ///< Queued tasks, the newest at the back.
+    };
+
+    /**
+     * Worker loop.
+     *
+     * @param index Worker index.
+     */
+    void run( size_t index );
+
+    /**
+     * Takes a task from the worker queue or steals one from another queue.
+     *
+     * @param index Worker index.
+     * @param t Task taken.
+     * @return True if a task was taken.
+     */
+    bool take( size_t index, task& t );
+
+    std::vector<queue*> queues_; ///< One queue per worker.
+    std::vector<std::thread> workers_; ///< Worker threads.
+
+    std::mutex mutex_; ///< Protects sleeping and finishing.
+    std::condition_variable work_available_; ///< Signals queued tasks.
+    std::condition_variable all_done_; ///< Signals pending_ reaching 0.
+
+    std::atomic<size_t> queued_; ///< Tasks in the queues, under their locks.
+    std::atomic<size_t> pending_; ///< Tasks queued or running.
+    std::atomic<size_t> next_queue_; ///< Queue for external submissions.
+    bool stop_; ///< Workers must exit, protected by mutex_.
+  };
+}
+
+#endif // PRECISION_WORK_STEALING_POOL_HXX
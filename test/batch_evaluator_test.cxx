@@ -0,0 +1,196 @@
+/*
+ * Checks precision::batch_evaluator against precision::tie_point and
+ * precision::evaluation_measurements run in sequence, on sets of mixed
+ * sizes split in many small bands, and precision::work_stealing_pool with
+ * tasks that submit tasks.
+ *
+ * Returns 0 on success.
+ */
+
+#include <precision/batch_evaluator.hxx>
+#include <precision/evaluation_measurements.hxx>
+#include <precision/work_stealing_pool.hxx>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+namespace {
+  typedef precision::batch_evaluator batch_evaluator;
+  typedef std::vector<precision::tie_point> tie_point_set;
+
+  double random_coordinate()
+  {
+    return 1000.0 * std::rand() / RAND_MAX;
+  }
+
+  tie_point_set make_set( size_t n )
+  {
+    tie_point_set set;
+
+    for( size_t i = 0; i < n; i++ ) {
+      double x = random_coordinate(), y = random_coordinate();
+      double u = 2.0 * x - 0.1 * y + random_coordinate() * 1e-2;
+      double v = 0.2 * x + 1.5 * y + random_coordinate() * 1e-2;
+
+      set.push_back( precision::tie_point( precision::point( x, y ),
+                                           precision::point( u, v ) ) );
+    }
+
+    // A duplicate for REMOVE_DUPLICATES.
+    if( n > 3 ) {
+      set.push_back( set[1] );
+    }
+    return set;
+  }
+
+  bool same( bool ok, double value, bool expected_ok, double expected )
+  {
+    if( ok != expected_ok ) {
+      return false;
+    }
+    double tolerance = 1e-9 * ( std::fabs( expected ) + 1.0 );
+    return !ok || std::fabs( value - expected ) <= tolerance;
+  }
+
+  /**
+   * Runs the whole pipeline in batch and in sequence.
+   *
+   * @return Number of failures.
+   */
+  int check_pipeline()
+  {
+    const size_t sizes[] = { 0, 1, 2, 3, 4, 17, 150, 400, 2, 300 };
+    const size_t count = sizeof( sizes ) / sizeof( sizes[0] );
+
+    std::vector<tie_point_set> sets;
+    for( size_t i = 0; i < count; i++ ) {
+      sets.push_back( make_set( sizes[i] ) );
+    }
+    std::vector<tie_point_set> expected_sets = sets;
+
+    std::vector<batch_evaluator::stage> pipeline;
+    pipeline.push_back( batch_evaluator::REMOVE_DUPLICATES );
+    pipeline.push_back( batch_evaluator::CHANGE_ORIGINS );
+    pipeline.push_back( batch_evaluator::LENGTH_VARIATION );
+    pipeline.push_back( batch_evaluator::ANISOMORPHISM );
+    pipeline.push_back( batch_evaluator::SIMILARITY );
+
+    // Small bands, so large sets are split in many tasks.
+    batch_evaluator evaluator( 4, 500 );
+    std::vector<batch_evaluator::result> results;
+
+    if( !evaluator.run( sets, pipeline, results, 0.0 ) ) {
+      std::printf( "run failed\n" );
+      return 1;
+    }
+
+    int failures = 0;
+
+    for( size_t i = 0; i < count; i++ ) {
+      tie_point_set& set = expected_sets[i];
+      precision::point xy0, uv0;
+
+      precision::tie_point::remove_duplicate_points( set, 0.0 );
+      if( !set.empty() ) {
+        precision::tie_point::compute_origins( set, xy0, uv0 );
+        precision::tie_point::change_origins( set, xy0, uv0 );
+      }
+
+      std::list<precision::tie_point> points( set.begin(), set.end() );
+      precision::evaluation_measurements measurements;
+      bool length_ok = measurements.estimate_length_var( points );
+      bool aniso_ok = measurements.estimate_anisomorphism( points );
+      bool similarity_ok = measurements.estimate_similarity( points );
+
+      const batch_evaluator::result& r = results[i];
+      bool ok = sets[i] == set &&
+        same( r.length_variation_ok, r.length_variation,
+              length_ok, measurements.get_length_variation() ) &&
+        same( r.anisomorphism_ok, r.anisomorphism,
+              aniso_ok, measurements.get_anisomorphism() ) &&
+        same( r.similarity_ok, r.similarity,
+              similarity_ok, measurements.get_similarity() );
+
+      std::printf( "set of %3zu: %zu tasks %s\n", sizes[i], r.tasks,
+                   ok ? "ok" : "FAILED" );
+      failures += !ok;
+    }
+
+    return failures;
+  }
+
+  /**
+   * Checks that invalid pipelines are rejected.
+   *
+   * @return Number of failures.
+   */
+  int check_invalid_pipelines()
+  {
+    std::vector<tie_point_set> sets( 1, make_set( 10 ) );
+    std::vector<batch_evaluator::result> results;
+    batch_evaluator evaluator( 2 );
+
+    std::vector<batch_evaluator::stage> repeated;
+    repeated.push_back( batch_evaluator::LENGTH_VARIATION );
+    repeated.push_back( batch_evaluator::LENGTH_VARIATION );
+
+    std::vector<batch_evaluator::stage> late;
+    late.push_back( batch_evaluator::SIMILARITY );
+    late.push_back( batch_evaluator::CHANGE_ORIGINS );
+
+    int failures = 0;
+    failures += evaluator.run( sets, repeated, results );
+    failures += evaluator.run( sets, late, results );
+
+    std::printf( "invalid pipelines %s\n", failures ? "FAILED" : "ok" );
+    return failures;
+  }
+
+  /**
+   * Runs tasks that submit more tasks and checks they all ran once.
+   *
+   * @return Number of failures.
+   */
+  int check_pool()
+  {
+    const size_t roots = 200, children = 50;
+    std::atomic<size_t> done( 0 );
+    int failures = 0;
+
+    precision::work_stealing_pool pool( 4 );
+
+    for( size_t round = 0; round < 20; round++ ) {
+      done = 0;
+
+      for( size_t i = 0; i < roots; i++ ) {
+        pool.submit( [&pool, &done]() {
+            for( size_t j = 0; j < children; j++ ) {
+              pool.submit( [&done]() { done++; } );
+            }
+            done++;
+          } );
+      }
+      pool.wait();
+
+      failures += ( done != roots * ( children + 1 ) );
+    }
+
+    std::printf( "work stealing pool %s\n", failures ? "FAILED" : "ok" );
+    return failures;
+  }
+}
+
+int main()
+{
+  std::srand( 1 );
+
+  int failures = check_pipeline();
+  failures += check_invalid_pipelines();
+  failures += check_pool();
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*
+ * Checks precision::cross_validation: the leave-one-out residuals derived
+ * from the hat matrix must match a real refit without the point, and an
+ * exact fit must not recommend anything for rounding noise.
+ *
+ * Returns 0 on success.
+ */
+
+#include <precision/cross_validation.hxx>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+  typedef precision::cross_validation cross_validation;
+
+  double noise( double amplitude )
+  {
+    return amplitude * ( 2.0 * std::rand() / RAND_MAX - 1.0 );
+  }
+
+  /**
+   * Tie points of a second order transformation, with @p amplitude noise
+   * on the reference points.
+   */
+  std::vector<precision::tie_point> make_tie_points( size_t n,
+                                                     double amplitude,
+                                                     bool polynomial )
+  {
+    std::vector<precision::tie_point> tie_points( n );
+
+    for( size_t i = 0; i < n; i++ ) {
+      double x = std::rand() % 4000, y = std::rand() % 3000;
+      double u = 512000.0 + 0.5 * x - 0.02 * y;
+      double v = 4100000.0 + 0.03 * x + 0.5 * y;
+
+      if( polynomial ) {
+        u += 1e-5 * x * y;
+        v -= 2e-5 * x * x;
+      }
+
+      tie_points[i].set( precision::point( x, y ),
+                         precision::point( u + noise( amplitude ),
+                                           v + noise( amplitude ) ),
+                         precision::tie_point::CONTROL );
+    }
+
+    return tie_points;
+  }
+
+  /**
+   * Largest difference between the leave-one-out residuals and the
+   * prediction errors of refits without each control point.
+   */
+  double refit_difference( cross_validation::transform t, double amplitude )
+  {
+    std::vector<precision::tie_point> tie_points =
+      make_tie_points( 40, amplitude, t == cross_validation::POLYNOMIAL_2 );
+
+    cross_validation full( t );
+    if( !full.evaluate( tie_points ) ) {
+      return HUGE_VAL;
+    }
+
+    double difference = 0.0;
+
+    for( size_t i = 0; i < tie_points.size(); i++ ) {
+      // A CHECK point is not fitted, its residual is the prediction error.
+      std::vector<precision::tie_point> left_out = tie_points;
+      left_out[i].set_type( precision::tie_point::CHECK );
+
+      cross_validation refit( t );
+      if( !refit.evaluate( left_out ) ) {
+        return HUGE_VAL;
+      }
+
+      const cross_validation::residual& loo = full.get_residuals()[i];
+      const cross_validation::residual& res = refit.get_residuals()[i];
+
+      difference = std::max( difference, std::fabs( loo.loo_u - res.u ) );
+      difference = std::max( difference, std::fabs( loo.loo_v - res.v ) );
+    }
+
+    return difference;
+  }
+
+  /**
+   * Number of recommendations on an exact affine fit.
+   */
+  size_t exact_fit_recommendations()
+  {
+    std::vector<precision::tie_point> tie_points =
+      make_tie_points( 50, 0.0, false );
+
+    cross_validation validation;
+    if( !validation.evaluate( tie_points ) ) {
+      return tie_points.size();
+    }
+
+    size_t count = 0;
+    for( size_t i = 0; i < tie_points.size(); i++ ) {
+      count += ( validation.get_residuals()[i].recommended !=
+                 cross_validation::KEEP );
+    }
+    return count;
+  }
+}
+
+int main()
+{
+  int failures = 0;
+
+  std::srand( 1 );
+
+  double affine = refit_difference( cross_validation::AFFINE, 0.5 );
+  double polynomial = refit_difference( cross_validation::POLYNOMIAL_2, 0.5 );
+
+  std::printf( "leave-one-out against refit: affine %g, polynomial %g\n",
+               affine, polynomial );
+  if( !( affine < 1e-8 ) || !( polynomial < 1e-8 ) ) {
+    failures++;
+  }
+
+  size_t recommended = exact_fit_recommendations();
+
+  std::printf( "recommendations on an exact fit: %zu\n", recommended );
+  if( recommended != 0 ) {
+    failures++;
+  }
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
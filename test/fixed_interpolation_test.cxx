@@ -0,0 +1,183 @@
+/*
+ * Checks that precision::fixed_interpolation::resample() gives, at every
+ * instruction set level supported by the running CPU, the same pixels as
+ * the scalar bilinear() and bicubic() methods: 8 and 16 bit pixels,
+ * saturated neighbourhoods, 1x1 sources and arbitrary scale factors.
+ *
+ * Returns 0 on success.
+ */
+
+#include <precision/cpu_dispatch.hxx>
+#include <precision/fixed_interpolation.hxx>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace {
+  using precision::cpu_dispatch;
+
+  /**
+   * Source position of a resampled pixel, as resample() computes it.
+   */
+  double source_position( size_t i, size_t size, size_t out_size,
+                          size_t& index )
+  {
+    double scale = static_cast<double>( size ) / out_size;
+    double c = ( i + 0.5 ) * scale - 0.5;
+    double last = static_cast<double>( size - 1 );
+
+    if( !( c > 0.0 ) ) {
+      c = 0.0;
+    } else if( c > last ) {
+      c = last;
+    }
+
+    double f = std::floor( c );
+    index = static_cast<size_t>( f );
+    return c - f;
+  }
+
+  size_t clamp_index( size_t index, int offset, size_t size )
+  {
+    long i = static_cast<long>( index ) + offset;
+
+    if( i < 0 ) {
+      return 0;
+    }
+    return ( static_cast<size_t>( i ) < size ) ? i : size - 1;
+  }
+
+  /**
+   * Counts the pixels of resample() that differ from the scalar methods.
+   */
+  template<class _PCS_PIXEL>
+  size_t mismatches( const std::vector<_PCS_PIXEL>& src, size_t width,
+                     size_t height, size_t out_width, size_t out_height,
+                     bool cubic )
+  {
+    typedef precision::fixed_interpolation<_PCS_PIXEL> fixed;
+
+    std::vector<_PCS_PIXEL> out( out_width * out_height );
+    if( !fixed::resample( &src[0], width, height, &out[0],
+                          out_width, out_height,
+                          cubic ? fixed::BICUBIC : fixed::BILINEAR ) ) {
+      return out.size();
+    }
+
+    size_t count = 0;
+    _PCS_PIXEL f[16];
+
+    for( size_t j = 0; j < out_height; j++ ) {
+      size_t iy;
+      double v = source_position( j, height, out_height, iy );
+
+      for( size_t i = 0; i < out_width; i++ ) {
+        size_t ix;
+        double u = source_position( i, width, out_width, ix );
+
+        for( int b = 0; b < 4; b++ ) {
+          for( int a = 0; a < 4; a++ ) {
+            f[4 * b + a] = src[clamp_index( iy, b - 1, height ) * width +
+                               clamp_index( ix, a - 1, width )];
+          }
+        }
+
+        _PCS_PIXEL r = cubic ? fixed::bicubic( f, u, v ) :
+                               fixed::bilinear( f[5], f[6], f[9], f[10],
+                                                u, v );
+        count += ( r != out[j * out_width + i] );
+      }
+    }
+    return count;
+  }
+
+  /**
+   * Checks one source image resampled to several sizes, in both modes.
+   *
+   * @return Number of failures.
+   */
+  template<class _PCS_PIXEL>
+  int check( const char* name, const std::vector<_PCS_PIXEL>& src,
+             size_t width, size_t height )
+  {
+    const size_t sizes[][2] = {
+      { 2 * width, 2 * height }, { 1, 1 }, { 13, 3 }, { 17, 29 },
+      { 3 * width + 1, ( height + 1 ) / 2 }
+    };
+    int failures = 0;
+
+    for( size_t s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); s++ ) {
+      for( int cubic = 0; cubic < 2; cubic++ ) {
+        size_t count = mismatches( src, width, height,
+                                   sizes[s][0], sizes[s][1], cubic != 0 );
+        if( count ) {
+          std::printf( "%s %s %zux%zu to %zux%zu: %zu mismatches\n", name,
+                       cubic ? "bicubic" : "bilinear", width, height,
+                       sizes[s][0], sizes[s][1], count );
+          failures++;
+        }
+      }
+    }
+    return failures;
+  }
+
+  /**
+   * Checks noise, a 0/max checkerboard that saturates bicubic at both
+   * ends, and a 1x1 source.
+   *
+   * @return Number of failures.
+   */
+  template<class _PCS_PIXEL>
+  int check_pixel( const char* name )
+  {
+    const _PCS_PIXEL max = std::numeric_limits<_PCS_PIXEL>::max();
+    const size_t width = 37, height = 23;
+    std::vector<_PCS_PIXEL> noise( width * height );
+    std::vector<_PCS_PIXEL> checkerboard( width * height );
+
+    for( size_t j = 0; j < height; j++ ) {
+      for( size_t i = 0; i < width; i++ ) {
+        noise[j * width + i] = static_cast<_PCS_PIXEL>( std::rand() );
+        checkerboard[j * width + i] = ( ( i + j ) % 2 ) ? max : 0;
+      }
+    }
+
+    std::vector<_PCS_PIXEL> single( 1, max / 3 );
+
+    int failures = check( name, noise, width, height );
+    failures += check( name, checkerboard, width, height );
+    failures += check( name, single, 1, 1 );
+    return failures;
+  }
+}
+
+int main()
+{
+  std::srand( 1 );
+
+  int failures = 0;
+  const cpu_dispatch::level levels[] = {
+    cpu_dispatch::GENERIC, cpu_dispatch::AVX2, cpu_dispatch::AVX512
+  };
+
+  for( size_t l = 0; l < sizeof( levels ) / sizeof( levels[0] ); l++ ) {
+    if( !cpu_dispatch::set_level( levels[l] ) ) {
+      continue;
+    }
+
+    int level_failures = check_pixel<uint8_t>( "uint8" );
+    level_failures += check_pixel<uint16_t>( "uint16" );
+
+    std::printf( "%-8s %s\n", cpu_dispatch::to_string( levels[l] ),
+                 level_failures ? "FAILED" : "ok" );
+    failures += level_failures;
+  }
+
+  cpu_dispatch::reset_level();
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
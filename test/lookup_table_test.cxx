@@ -0,0 +1,129 @@
+/*
+ * Checks that precision::lookup_table reproduces linear functions in both
+ * modes, on uniform and non-uniform nodes, through at() and apply() at
+ * every instruction set level supported by the running CPU.
+ *
+ * Returns 0 on success.
+ */
+
+#include <precision/cpu_dispatch.hxx>
+#include <precision/lookup_table.hxx>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+  typedef precision::lookup_table lookup_table;
+  using precision::cpu_dispatch;
+
+  /// Linear function the tables sample.
+  double line( double x )
+  {
+    return 3.0 * x - 2.0;
+  }
+
+  /**
+   * Largest relative error of a table, through at() and apply(), at
+   * values spread over and around its range.
+   */
+  double max_error( const lookup_table& table, double first, double last )
+  {
+    const size_t n = 1000;
+    std::vector<double> in( n ), out( n );
+
+    for( size_t i = 0; i < n; i++ ) {
+      in[i] = first + ( last - first ) * ( i / ( n - 1.0 ) );
+    }
+    table.apply( &in[0], &out[0], n );
+
+    double error = 0.0;
+    for( size_t i = 0; i < n; i++ ) {
+      double expected = line( in[i] );
+      double scale = std::fabs( expected ) + 1.0;
+
+      error = std::max( error, std::fabs( out[i] - expected ) / scale );
+      error = std::max( error,
+                        std::fabs( table.at( in[i] ) - expected ) / scale );
+    }
+    return error;
+  }
+
+  /**
+   * Checks a table of the given nodes in both modes.
+   *
+   * @return Number of failures.
+   */
+  int check( const char* name, const std::vector<double>& x,
+             bool expect_uniform )
+  {
+    std::vector<double> f( x.size() );
+    for( size_t i = 0; i < x.size(); i++ ) {
+      f[i] = line( x[i] );
+    }
+
+    int failures = 0;
+    const lookup_table::mode modes[] = {
+      lookup_table::LINEAR, lookup_table::CUBIC
+    };
+
+    for( size_t m = 0; m < 2; m++ ) {
+      lookup_table table( x, f, modes[m] );
+      double error = max_error( table, x.front(), x.back() );
+      bool ok = error < 1e-12 && table.is_uniform() == expect_uniform;
+
+      std::printf( "%-12s %-6s %-8s %g\n", name,
+                   modes[m] == lookup_table::CUBIC ? "cubic" : "linear",
+                   cpu_dispatch::to_string( cpu_dispatch::get_level() ),
+                   error );
+      failures += !ok;
+    }
+    return failures;
+  }
+}
+
+int main()
+{
+  std::vector<double> uniform( 64 ), geometric( 40 ), jittered( 200 );
+  std::vector<double> pair( 2 );
+
+  for( size_t i = 0; i < uniform.size(); i++ ) {
+    uniform[i] = -5.0 + 0.25 * i;
+  }
+
+  // Ratio 1.5: neighbour spacings differ a lot.
+  double x = 1.0;
+  for( size_t i = 0; i < geometric.size(); i++ ) {
+    geometric[i] = x;
+    x *= 1.5;
+  }
+
+  std::srand( 1 );
+  for( size_t i = 0; i < jittered.size(); i++ ) {
+    jittered[i] = i + 0.45 * std::rand() / RAND_MAX;
+  }
+
+  pair[0] = 2.0;
+  pair[1] = 7.0;
+
+  int failures = 0;
+  const cpu_dispatch::level levels[] = {
+    cpu_dispatch::GENERIC, cpu_dispatch::AVX2, cpu_dispatch::AVX512
+  };
+
+  for( size_t l = 0; l < sizeof( levels ) / sizeof( levels[0] ); l++ ) {
+    if( !cpu_dispatch::set_level( levels[l] ) ) {
+      continue;
+    }
+
+    failures += check( "uniform", uniform, true );
+    failures += check( "two nodes", pair, true );
+    failures += check( "geometric", geometric, false );
+    failures += check( "jittered", jittered, false );
+  }
+
+  cpu_dispatch::reset_level();
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
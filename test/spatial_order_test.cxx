@@ -0,0 +1,286 @@
+/*
+ * Checks that precision::spatial_order gives a stable permutation in key
+ * order, the same with one and several threads, that Hilbert keys of
+ * neighbour cells are adjacent, and that NaN and equal coordinates are
+ * handled.
+ *
+ * Returns 0 on success.
+ */
+
+#include <precision/spatial_order.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace {
+  using precision::spatial_order;
+  using precision::point3d;
+
+  /// Random coordinate in [0, range).
+  double random_coordinate( double range )
+  {
+    return range * ( std::rand() / ( RAND_MAX + 1.0 ) );
+  }
+
+  /**
+   * Keys of points, quantized on their bounding box as spatial_order
+   * does, NaN coordinates out of the box and at its origin.
+   */
+  std::vector<uint64_t> keys( const std::vector<double>* coords,
+                              size_t dims, spatial_order::curve c )
+  {
+    const size_t bits = ( dims == 2 ) ? 22 : 21;
+    const double limit = static_cast<double>( ( uint64_t( 1 ) << bits ) - 1 );
+    const size_t n = coords[0].size();
+    double origin[3], scale[3];
+
+    for( size_t a = 0; a < dims; a++ ) {
+      double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+
+      for( size_t i = 0; i < n; i++ ) {
+        if( coords[a][i] == coords[a][i] ) {
+          lo = std::min( lo, coords[a][i] );
+          hi = std::max( hi, coords[a][i] );
+        }
+      }
+
+      origin[a] = lo;
+      scale[a] = ( hi > lo ) ? limit / ( hi - lo ) : 0.0;
+    }
+
+    std::vector<uint64_t> k( n );
+    uint32_t q[3];
+
+    for( size_t i = 0; i < n; i++ ) {
+      for( size_t a = 0; a < dims; a++ ) {
+        double t = ( coords[a][i] - origin[a] ) * scale[a];
+        q[a] = !( t > 0.0 ) ? 0 :
+          ( t < limit ? static_cast<uint32_t>( t )
+                      : static_cast<uint32_t>( limit ) );
+      }
+
+      k[i] = ( c == spatial_order::HILBERT ) ?
+        spatial_order::hilbert_key( q, dims, bits ) :
+        spatial_order::morton_key( q, dims, bits );
+    }
+    return k;
+  }
+
+  /**
+   * Checks that a permutation is a bijection, puts the keys in order and
+   * keeps the order of equal keys.
+   */
+  bool is_stable_order( const std::vector<size_t>& permutation,
+                        const std::vector<uint64_t>& k )
+  {
+    const size_t n = k.size();
+    std::vector<bool> seen( n, false );
+
+    if( permutation.size() != n ) {
+      return false;
+    }
+
+    for( size_t i = 0; i < n; i++ ) {
+      size_t p = permutation[i];
+      if( p >= n || seen[p] ) {
+        return false;
+      }
+      seen[p] = true;
+
+      if( i > 0 ) {
+        size_t q = permutation[i - 1];
+        if( k[q] > k[p] || ( k[q] == k[p] && q > p ) ) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Orders a point cloud with one and four threads and checks both.
+   *
+   * @return Number of failures.
+   */
+  int check_cloud( const char* name, const std::vector<point3d>& cloud,
+                   spatial_order::curve c )
+  {
+    std::vector<double> coords[3];
+
+    for( size_t i = 0; i < cloud.size(); i++ ) {
+      double x, y, z;
+      cloud[i].get_xyz( x, y, z );
+      coords[0].push_back( x );
+      coords[1].push_back( y );
+      coords[2].push_back( z );
+    }
+
+    std::vector<uint64_t> k = keys( coords, 3, c );
+    std::vector<size_t> single, several;
+
+    spatial_order( c, 1 ).compute( cloud, single );
+    spatial_order( c, 4 ).compute( cloud, several );
+
+    if( !is_stable_order( single, k ) || single != several ) {
+      std::printf( "%s cloud, curve %d: FAILED\n", name, c );
+      return 1;
+    }
+    return 0;
+  }
+
+  /**
+   * Orders tie points by work and reference coordinates with one and four
+   * threads and checks both.
+   *
+   * @return Number of failures.
+   */
+  int check_tie_points( const char* name,
+                        const std::vector<precision::tie_point>& tie_points,
+                        spatial_order::curve c )
+  {
+    int failures = 0;
+
+    for( int s = 0; s < 2; s++ ) {
+      std::vector<double> coords[2];
+
+      for( size_t i = 0; i < tie_points.size(); i++ ) {
+        precision::point x_y, u_v;
+        tie_points[i].get( x_y, u_v );
+
+        const precision::point& p = s ? u_v : x_y;
+        coords[0].push_back( p.get_x() );
+        coords[1].push_back( p.get_y() );
+      }
+
+      spatial_order::space space = s ? spatial_order::REFERENCE_SPACE :
+                                       spatial_order::WORK_SPACE;
+      std::vector<uint64_t> k = keys( coords, 2, c );
+      std::vector<size_t> single, several;
+
+      spatial_order( c, 1 ).compute( tie_points, single, space );
+      spatial_order( c, 4 ).compute( tie_points, several, space );
+
+      if( !is_stable_order( single, k ) || single != several ) {
+        std::printf( "%s tie points, curve %d, space %d: FAILED\n",
+                     name, c, s );
+        failures++;
+      }
+    }
+    return failures;
+  }
+
+  /**
+   * Checks that consecutive Hilbert keys of a 2^bits grid are neighbour
+   * cells.
+   *
+   * @return Number of failures.
+   */
+  int check_hilbert_adjacency( size_t dims, size_t bits )
+  {
+    const size_t side = size_t( 1 ) << bits;
+    const size_t cells = size_t( 1 ) << ( dims * bits );
+    std::vector<uint32_t> cell( cells * dims );
+    std::vector<bool> seen( cells, false );
+
+    for( size_t i = 0; i < cells; i++ ) {
+      uint32_t q[3];
+      for( size_t a = 0, r = i; a < dims; a++, r /= side ) {
+        q[a] = static_cast<uint32_t>( r % side );
+      }
+
+      uint64_t key = spatial_order::hilbert_key( q, dims, bits );
+      if( key >= cells || seen[key] ) {
+        std::printf( "hilbert %zuD %zu bits: keys not a bijection\n",
+                     dims, bits );
+        return 1;
+      }
+      seen[key] = true;
+
+      for( size_t a = 0; a < dims; a++ ) {
+        cell[key * dims + a] = q[a];
+      }
+    }
+
+    for( size_t key = 1; key < cells; key++ ) {
+      size_t distance = 0;
+      for( size_t a = 0; a < dims; a++ ) {
+        long d = static_cast<long>( cell[key * dims + a] ) -
+                 static_cast<long>( cell[( key - 1 ) * dims + a] );
+        distance += std::labs( d );
+      }
+
+      if( distance != 1 ) {
+        std::printf( "hilbert %zuD %zu bits: keys %zu and %zu not adjacent\n",
+                     dims, bits, key - 1, key );
+        return 1;
+      }
+    }
+    return 0;
+  }
+}
+
+int main()
+{
+  std::srand( 1 );
+
+  int failures = 0;
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  failures += check_hilbert_adjacency( 2, 1 );
+  failures += check_hilbert_adjacency( 2, 4 );
+  failures += check_hilbert_adjacency( 3, 1 );
+  failures += check_hilbert_adjacency( 3, 3 );
+
+  // More points than two radix sort chunks, with repeated coordinates.
+  const size_t n = 100000;
+  std::vector<point3d> cloud, flat( 50000, point3d( 1.0, -2.0, 3.0 ) );
+  std::vector<precision::tie_point> tie_points;
+
+  for( size_t i = 0; i < n; i++ ) {
+    double x = std::floor( random_coordinate( 200.0 ) ) - 100.0;
+    double y = random_coordinate( 1.0 );
+    double z = std::floor( random_coordinate( 8.0 ) );
+
+    cloud.push_back( point3d( x, y, z ) );
+    tie_points.push_back(
+      precision::tie_point( precision::point( x, y ),
+                            precision::point( z, -x ) ) );
+  }
+
+  // A few NaN coordinates, which must not change the bounding box.
+  std::vector<point3d> holes( cloud );
+  for( size_t i = 0; i < n; i += 997 ) {
+    holes[i] = point3d( nan, holes[i].get_y(), ( i % 2 ) ? nan : 5.0 );
+  }
+
+  const spatial_order::curve curves[] = {
+    spatial_order::MORTON, spatial_order::HILBERT
+  };
+
+  for( size_t c = 0; c < sizeof( curves ) / sizeof( curves[0] ); c++ ) {
+    failures += check_cloud( "random", cloud, curves[c] );
+    failures += check_cloud( "nan", holes, curves[c] );
+    failures += check_cloud( "equal", flat, curves[c] );
+    failures += check_tie_points( "random", tie_points, curves[c] );
+  }
+
+  // Equal coordinates give equal keys, so the order is the identity.
+  std::vector<size_t> permutation;
+  spatial_order( spatial_order::HILBERT, 4 ).compute( flat, permutation );
+  for( size_t i = 0; i < permutation.size(); i++ ) {
+    if( permutation[i] != i ) {
+      std::printf( "equal cloud: not the identity\n" );
+      failures++;
+      break;
+    }
+  }
+
+  std::printf( "%s\n", failures ? "FAILED" : "ok" );
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}